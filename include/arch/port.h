@@ -17,9 +17,16 @@
         "pop  {r7}   \n" \
         "bx lr       \n" ::"i"(num))
 
+/* Flag of the syscall number for bypassing the fast path of the SVC handler,
+ * the syscall is always dispatched by the kernel loop */
+#define SYSCALL_SLOW_PATH 0x80
+
+#define SYSCALL_SLOW(num) SYSCALL((num) | SYSCALL_SLOW_PATH)
+
 #define SAVE_SYSCALL_RETVAL(ptr) asm volatile("mov %0, r0" : "=r"(*ptr));
 
 void system_ticks_update(void);
+void system_hrtimer_update(void);
 
 /**
  * @brief  Get the current ARM processor mode
@@ -49,6 +56,14 @@ void *jump_to_thread(void *stack, bool privileged);
  */
 void jump_to_kernel(void);
 
+/**
+ * @brief  Request the running thread to jump back to the kernel for
+ *         rescheduling as soon as the preemption is enabled
+ * @param  None
+ * @retval None
+ */
+void request_context_switch(void);
+
 /**
  * @brief  Basic platform initialization
  * @param  None
@@ -105,4 +120,46 @@ void halt(void);
  */
 void __idle(void);
 
+/**
+ * @brief  Stop the periodic tick and idle until the given number of ticks
+ *         passed or an interrupt arrived. Must be called with preemption
+ *         disabled
+ * @param  ticks: The number of ticks to idle, the last one will be handled
+ *         by the tick handler as usual.
+ * @retval uint32_t: The number of ticks passed without running the tick
+ *         handler.
+ */
+uint32_t __idle_ticks(uint32_t ticks);
+
+/**
+ * @brief  Read the free-running counter of the clocksource. The counter must
+ *         be readable from the unprivileged mode for reading the time without
+ *         syscalls
+ * @param  None
+ * @retval uint32_t: The counter value, which wraps around on overflow.
+ */
+uint32_t __clocksource_read(void);
+
+/**
+ * @brief  Get the counting frequency of the clocksource
+ * @param  None
+ * @retval uint32_t: The frequency in Hz, which must be a multiple of 1MHz.
+ */
+uint32_t __clocksource_freq(void);
+
+/**
+ * @brief  Get the clock frequency of the CPU core
+ * @param  None
+ * @retval uint32_t: The frequency in Hz.
+ */
+uint32_t __cpu_freq(void);
+
+/**
+ * @brief  Arm the one-shot high-resolution timer, system_hrtimer_update()
+ *         is called once it expired. Rearming overrides the previous setting
+ * @param  usec: The microseconds to expire.
+ * @retval None
+ */
+void __hrtimer_start(uint32_t usec);
+
 #endif
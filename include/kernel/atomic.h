@@ -0,0 +1,21 @@
+/**
+ * @file
+ */
+#ifndef __KERNEL_ATOMIC_H__
+#define __KERNEL_ATOMIC_H__
+
+/* Prevent the compiler from reordering memory accesses across the barrier */
+#define barrier() asm volatile("" ::: "memory")
+
+/**
+ * @brief  Atomically compare the value of the given address with the old
+ *         value and replace it with the new value if they are equal
+ * @param  ptr: Pointer to the value to compare and exchange.
+ * @param  old: The value expected to be stored.
+ * @param  new: The value to store if the comparison succeeded.
+ * @retval unsigned long: The value read before the exchange. The exchange
+ *         succeeded if it equals to the old value.
+ */
+unsigned long cmpxchg(unsigned long *ptr, unsigned long old, unsigned long new);
+
+#endif
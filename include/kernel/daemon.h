@@ -19,5 +19,6 @@ enum {
 
 void set_daemon_id(int daemon);
 uint16_t get_daemon_id(int daemon);
+struct thread_info *get_daemon_thread(int daemon);
 
 #endif
@@ -0,0 +1,58 @@
+/**
+ * @file
+ */
+#ifndef __KERNEL_EVENT_H__
+#define __KERNEL_EVENT_H__
+
+#include <stdint.h>
+#include <time.h>
+
+#include <common/list.h>
+
+struct event_group {
+    volatile uint32_t bits;
+    struct list_head wait_list;
+};
+
+/**
+ * @brief  Initialize the event group
+ * @param  group: Pointer to the event group.
+ * @retval None
+ */
+void event_group_init(struct event_group *group);
+
+/**
+ * @brief  Set the event bits and wake up the threads whose waiting
+ *         conditions are satisfied. The function can be called from the
+ *         interrupt handlers
+ * @param  group: Pointer to the event group.
+ * @param  bits: The event bits to set.
+ * @retval None
+ */
+void event_group_set(struct event_group *group, uint32_t bits);
+
+/**
+ * @brief  Clear the event bits. The function can be called from the
+ *         interrupt handlers
+ * @param  group: Pointer to the event group.
+ * @param  bits: The event bits to clear.
+ * @retval None
+ */
+void event_group_clear(struct event_group *group, uint32_t bits);
+
+/**
+ * @brief  Wait until any or all of the event bits are set
+ * @param  group: Pointer to the event group.
+ * @param  bits: The event bits to wait for, and for returning the bits that
+ *         are set among them.
+ * @param  options: EVENT_WAIT_ANY or EVENT_WAIT_ALL, optionally combined
+ *         with EVENT_AUTO_CLEAR.
+ * @param  timeout: The maximum time to wait, or NULL to wait forever.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int event_group_wait(struct event_group *group,
+                     uint32_t *bits,
+                     int options,
+                     const struct timespec *timeout);
+
+#endif
@@ -21,16 +21,19 @@
 
 #include "kconfig.h"
 
-#define DEF_SYSCALL(func, _num)                                 \
-    {                                                           \
-        .handler_func = (unsigned long) sys_##func, .num = _num \
-    }
+#define DEF_SYSCALL(func, _num) [_num] = (unsigned long) sys_##func
 
 #define SYSCALL_ARG(thread, type, idx) *((type *) thread->syscall_args[idx])
 
-struct syscall_info {
-    unsigned long handler_func;
-    uint32_t num;
+struct ss_repl {
+    uint32_t tick;   /* Absolute tick to replenish the budget */
+    uint32_t amount; /* Budget to replenish in ticks */
+};
+
+/* Reader-writer lock held by the thread for reading */
+struct rwlock_hold {
+    struct rwlock *rwlock;
+    uint32_t cnt; /* Times of the lock acquired for reading */
 };
 
 struct staged_handler_info {
@@ -80,19 +83,28 @@ struct thread_info {
     unsigned long *syscall_stack_top;
     bool syscall_mode;
     bool syscall_is_timeout; /* Indicate if the syscall waiting time is up */
-    struct timespec syscall_timeout; /* For setting timeout of the syscall */
+    uint32_t timeout_tick;   /* Absolute tick of the syscall deadline */
 
     /* Thread */
     void *retval;               /* For passing retval after the thread end */
     void **retval_join;         /* To getting retval from a thread to join */
     size_t file_request_size;   /* Size of the thread requesting to a file */
-    uint32_t sleep_ticks;       /* Remained ticks to sleep */
+    uint32_t wakeup_tick;       /* Absolute tick to wake up from sleep */
+    ktime_t wakeup_ns;          /* Absolute ns to wake up from nanosleep */
     uint32_t preempt_cnt;       /* For preserving threads's preemption level */
+    uint32_t time_slice;        /* Ticks left of the SCHED_RR time slice */
+    uint64_t cpu_cycles;        /* Clocksource cycles spent on the CPU */
+    uint32_t nvcsw;             /* Number of voluntary context switches */
+    uint32_t nivcsw;            /* Number of involuntary context switches */
+    uint32_t event_bits;        /* Event bits to wait for or that are set */
+    int event_options;          /* Options of waiting for the events */
     uint16_t tid;               /* Thread ID */
+    uint16_t gen;               /* Generation counter of the control block */
     uint16_t timer_cnt;         /* The number of timers that the thread has */
     uint8_t privilege;          /* Current execution privilege level */
     uint8_t status;             /* Thread status */
     uint8_t priority;           /* Thread priority */
+    uint8_t sched_policy;       /* Scheduling policy */
     uint8_t original_priority;  /* Original priority before inheritance */
     bool kernel_thread;         /* Kernel thread or user thread */
     bool priority_inherited;    /* True if current priority is inherited */
@@ -101,6 +113,30 @@ struct thread_info {
     char name[THREAD_NAME_MAX]; /* Thread name */
     struct thread_once *once_control; /* For handling pthread_once_control */
 
+    /* Deadline scheduling (in ticks) */
+    uint32_t dl_runtime;      /* Budget of every period */
+    uint32_t dl_deadline;     /* Relative deadline of every period */
+    uint32_t dl_period;       /* Length of the period */
+    uint32_t dl_budget;       /* Budget left for the current job */
+    uint32_t dl_abs_deadline; /* Absolute tick of the current deadline */
+    uint32_t dl_bw;           /* Reserved CPU bandwidth */
+    uint32_t dl_misses;       /* Number of the deadline misses */
+    bool dl_missed;           /* The current job has missed the deadline */
+
+    /* Sporadic server (in ticks) */
+    uint32_t ss_init_budget;  /* Full budget */
+    uint32_t ss_repl_period;  /* Replenishment period */
+    uint32_t ss_budget;       /* Budget left */
+    uint32_t ss_activation;   /* Absolute tick the thread became runnable */
+    uint32_t ss_consumed;     /* Budget consumed since the activation */
+    uint8_t ss_max_repl;      /* Max number of pending replenishments */
+    uint8_t ss_repl_cnt;      /* Number of pending replenishments */
+    bool ss_active;           /* The thread is consuming the budget */
+
+    struct ss_repl ss_repl[SS_REPL_MAX]; /* Pending replenishments */
+    uint32_t throttle_cnt;               /* Times of exhausting the budget */
+    bool throttled;                      /* Waiting for the replenishment */
+
     /* Signals */
     struct sigaction *sig_table[SIGNAL_CNT];
     struct kfifo signal_queue; /* The queue for pending signals */
@@ -109,6 +145,9 @@ struct thread_info {
     int *ret_sig;              /* For storing retval of the sigwait */
     bool wait_for_signal;      /* Indicates the thread is waiting for signal */
 
+    /* Reader-writer locks held for reading */
+    struct rwlock_hold rwlock_holds[RWLOCK_READ_MAX];
+
     /* Lists */
     struct list_head timers_list;     /* List of timers belongs to the thread */
     struct list_head poll_files_list; /* List of all files polling for */
@@ -116,7 +155,10 @@ struct thread_info {
     struct list_head thread_list;     /* Linked to the global thread list */
     struct list_head timeout_list;    /* Linked to the global timeout list */
     struct list_head join_list; /* Linked to another thread waiting for join */
+    struct list_head pi_mutexes; /* Held mutexes that raise the priority */
+    struct mutex *blocked_on;    /* The mutex that the thread waits for */
     struct list_head list;      /* Linked to a scheduling list */
+    struct list_head *wait_list; /* The wait list that the thread sleeps on */
 };
 
 #endif
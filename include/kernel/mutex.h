@@ -10,20 +10,32 @@
 
 struct mutex_attr {
     int protocol;
+    int prioceiling;
 };
 
+/* Flag on the owner word to force the owner to unlock with the slow path */
+#define MUTEX_WAITERS 0x1UL
+
 struct mutex {
     int protocol;
-    struct thread_info *owner;
+    int prioceiling;     /* Priority ceiling of PTHREAD_PRIO_PROTECT */
+    unsigned long owner; /* Owner thread pointer with MUTEX_WAITERS flag */
     struct list_head wait_list;
+    struct list_head pi_list; /* Linked to the held mutex list of the owner */
 };
 
 struct cond {
     struct list_head task_wait_list;
 };
 
+static inline struct thread_info *mutex_owner(struct mutex *mtx)
+{
+    return (struct thread_info *) (mtx->owner & ~MUTEX_WAITERS);
+}
+
 void __mutex_init(struct mutex *mtx);
 void thread_inherit_priority(struct mutex *mutex);
+void thread_raise_ceiling(struct mutex *mutex);
 void thread_reset_inherited_priority(struct mutex *mutex);
 
 /**
@@ -42,7 +54,7 @@ bool mutex_is_locked(struct mutex *mtx);
 
 /**
  * @brief  Lock the mutex. If the mutex is currently locked then the function
- *         shall return immediately
+ *         shall return immediately with -EBUSY
  * @param  mtx: Pointer to the mutex.
  * @retval int: 0 on success and nonzero error number on error.
  */
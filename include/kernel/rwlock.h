@@ -0,0 +1,73 @@
+/**
+ * @file
+ */
+#ifndef __KERNEL_RWLOCK_H__
+#define __KERNEL_RWLOCK_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <common/list.h>
+
+struct rwlock_attr {
+    int kind;
+};
+
+struct rwlock {
+    int32_t count;              /* Readers holding the lock, or -1 if written */
+    bool prefer_writer;         /* Readers wait if any writer is waiting */
+    bool writer_woken;          /* A woken writer is about to take the lock */
+    struct thread_info *writer; /* The thread holding the write lock */
+    struct list_head read_wait_list;
+    struct list_head write_wait_list;
+};
+
+/**
+ * @brief  Initialize the reader-writer lock
+ * @param  rwlock: Pointer to the reader-writer lock.
+ * @param  prefer_writer: Give the waiting writers precedence over the
+ *         readers regardless of the priorities.
+ * @retval None
+ */
+void rwlock_init(struct rwlock *rwlock, bool prefer_writer);
+
+/**
+ * @brief  Lock the reader-writer lock for reading. The thread can hold the
+ *         lock for reading multiple times, and at most RWLOCK_READ_MAX
+ *         different locks for reading
+ * @param  rwlock: Pointer to the reader-writer lock.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int rwlock_rdlock(struct rwlock *rwlock);
+
+/**
+ * @brief  The same as rwlock_rdlock(), except that if the lock can't be
+ *         acquired immediately, then call returns -EBUSY instead of blocking
+ * @param  rwlock: Pointer to the reader-writer lock.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int rwlock_tryrdlock(struct rwlock *rwlock);
+
+/**
+ * @brief  Lock the reader-writer lock for writing
+ * @param  rwlock: Pointer to the reader-writer lock.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int rwlock_wrlock(struct rwlock *rwlock);
+
+/**
+ * @brief  The same as rwlock_wrlock(), except that if the lock can't be
+ *         acquired immediately, then call returns -EBUSY instead of blocking
+ * @param  rwlock: Pointer to the reader-writer lock.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int rwlock_trywrlock(struct rwlock *rwlock);
+
+/**
+ * @brief  Release the reader or writer lock held by the calling thread
+ * @param  rwlock: Pointer to the reader-writer lock.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int rwlock_unlock(struct rwlock *rwlock);
+
+#endif
@@ -4,6 +4,8 @@
 #ifndef __KERNEL_SCHED_H__
 #define __KERNEL_SCHED_H__
 
+#include <stdint.h>
+
 /**
  * @brief  Relinquish CPU and select next thread to run
  * @param  None
@@ -11,4 +13,15 @@
  */
 void schedule(void);
 
+/**
+ * @brief  Save the stack pointer of the preempted thread and select the next
+ *         thread to run. Called by the PendSV handler for switching threads
+ *         directly without returning to the kernel loop
+ * @param  stack_top: Stack pointer of the preempted thread after saving its
+ *         context.
+ * @param  privilege: For returning the privilege of the next thread.
+ * @retval void*: Stack pointer of the next thread.
+ */
+void *sched_switch(void *stack_top, uint32_t *privilege);
+
 #endif
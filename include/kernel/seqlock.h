@@ -0,0 +1,112 @@
+/**
+ * @file
+ */
+#ifndef __KERNEL_SEQLOCK_H__
+#define __KERNEL_SEQLOCK_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <kernel/atomic.h>
+
+/* Sequence counter for sharing data with a single writer. The writer never
+ * blocks, and the readers retry if the data was changed while reading */
+struct seqcount {
+    volatile uint32_t sequence;
+};
+
+/* Double buffer of the latest value protected by a latched sequence
+ * counter, see write_seqcount_latch() */
+struct seqbuf {
+    struct seqcount seq;
+    void *data;  /* Storage of the two copies */
+    size_t size; /* Size of one copy in bytes */
+};
+
+static inline void seqcount_init(struct seqcount *s)
+{
+    s->sequence = 0;
+}
+
+/**
+ * @brief  Start reading the data protected by the sequence counter
+ * @param  s: Pointer to the sequence counter.
+ * @retval uint32_t: The sequence to check with read_seqcount_retry().
+ */
+static inline uint32_t read_seqcount_begin(const struct seqcount *s)
+{
+    uint32_t seq = s->sequence;
+    barrier();
+    return seq;
+}
+
+/**
+ * @brief  Check if the data was being written or was changed while reading.
+ *         Note that the reader must not preempt the writer, otherwise it
+ *         retries forever. Use the latched variant in that case
+ * @param  s: Pointer to the sequence counter.
+ * @param  start: The sequence returned by read_seqcount_begin().
+ * @retval bool: true if the reading has to be retried.
+ */
+static inline bool read_seqcount_retry(const struct seqcount *s,
+                                       uint32_t start)
+{
+    barrier();
+    return (start & 1) || s->sequence != start;
+}
+
+/**
+ * @brief  Start writing the data protected by the sequence counter
+ * @param  s: Pointer to the sequence counter.
+ * @retval None
+ */
+static inline void write_seqcount_begin(struct seqcount *s)
+{
+    s->sequence++;
+    barrier();
+}
+
+/**
+ * @brief  Finish writing the data protected by the sequence counter
+ * @param  s: Pointer to the sequence counter.
+ * @retval None
+ */
+static inline void write_seqcount_end(struct seqcount *s)
+{
+    barrier();
+    s->sequence++;
+}
+
+/**
+ * @brief  Publish the copy the writer has just updated. With the latched
+ *         sequence counter, the readers use the copy (sequence & 1) while
+ *         the writer updates the other one, so the readers never observe
+ *         the writer in progress
+ * @param  s: Pointer to the sequence counter.
+ * @retval None
+ */
+static inline void write_seqcount_latch(struct seqcount *s)
+{
+    barrier();
+    s->sequence++;
+    barrier();
+}
+
+/**
+ * @brief  Check if the copy selected by the latched sequence counter was
+ *         overwritten while reading. Unlike read_seqcount_retry(), the
+ *         reader never waits for the writer in progress, and only retries
+ *         if the writer published a new copy during the read
+ * @param  s: Pointer to the sequence counter.
+ * @param  start: The sequence returned by read_seqcount_begin().
+ * @retval bool: true if the reading has to be retried.
+ */
+static inline bool read_seqcount_latch_retry(const struct seqcount *s,
+                                             uint32_t start)
+{
+    barrier();
+    return s->sequence != start;
+}
+
+#endif
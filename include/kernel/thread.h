@@ -25,6 +25,6 @@ struct thread_once {
 };
 
 struct thread_info *current_thread_info(void);
-struct thread_info *acquire_thread(int tid);
+struct thread_info *acquire_thread(pthread_t tid);
 
 #endif
@@ -9,6 +9,12 @@
 
 #include <common/list.h>
 
+/* Compare two tick counts with wrap-around taken into account */
+#define time_after(a, b) ((int32_t) ((b) - (a)) < 0)
+#define time_after_eq(a, b) ((int32_t) ((a) - (b)) >= 0)
+#define time_before(a, b) time_after(b, a)
+#define time_before_eq(a, b) time_after_eq(b, a)
+
 typedef int64_t ktime_t;
 
 struct timer {
@@ -17,10 +23,10 @@ struct timer {
     bool enabled;
     struct sigevent sev;
     struct itimerspec setting;
-    struct itimerspec ret_time; /* For returning current time */
-    struct timespec counter;    /* Internal countdown counter */
+    uint32_t expire_tick;       /* Absolute tick of the next expiration */
+    uint32_t interval_ticks;    /* Reload ticks of the periodic timer */
     struct thread_info *thread; /* The thread that the timer belongs to */
-    struct list_head g_list;    /* Linked to the global timer list */
+    struct list_head g_list;    /* Linked to a bucket of the timer wheel */
     struct list_head list;      /* Linked to the thread timer list */
 };
 
@@ -28,9 +34,15 @@ void timer_up_count(struct timespec *time);
 void timer_down_count(struct timespec *time);
 void time_add(struct timespec *time, time_t sec, long nsec);
 void get_sys_time(struct timespec *tp);
-void set_sys_time(const struct timespec *tp);
+void get_sys_realtime(struct timespec *tp);
+void set_sys_realtime(const struct timespec *tp);
 void system_timer_update(void);
+void system_timer_skip(uint32_t ticks);
+uint32_t get_sys_ticks(void);
+uint32_t timespec_to_ticks(const struct timespec *tp);
+void ticks_to_timespec(uint32_t ticks, struct timespec *tp);
 
 ktime_t ktime_get(void);
+ktime_t ktime_get_ns(void);
 
 #endif
@@ -5,6 +5,7 @@
 #define __KERNEL_WAIT_H__
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include <common/list.h>
 #include <kernel/kernel.h>
@@ -56,6 +57,28 @@ void prepare_to_wait(struct list_head *wait_list,
                      struct thread_info *thread,
                      int state);
 
+/**
+ * @brief  The same as prepare_to_wait(), except that the thread is also
+ *         woken up if the given time is up
+ * @param  wait_list: Thread waiting list.
+ * @param  thread: The thread to to place in the wait list.
+ * @param  state: The new state of the thread.
+ * @param  ticks: The maximum ticks to wait.
+ * @retval None
+ */
+void prepare_to_wait_timeout(struct list_head *wait_list,
+                             struct thread_info *thread,
+                             int state,
+                             uint32_t ticks);
+
+/**
+ * @brief  Stop the timeout set by prepare_to_wait_timeout() after the
+ *         thread is woken up
+ * @param  thread: The thread that was waiting.
+ * @retval bool: true if the thread was woken up by the timeout.
+ */
+bool finish_wait_timeout(struct thread_info *thread);
+
 /**
  * @brief  Wake up the highest priority thread from the wait list
  * @param  wait_list: The wait list that contains suspended threads.
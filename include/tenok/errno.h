@@ -32,6 +32,7 @@
 #define EDEADLK 45      /**< Deadlock */
 #define ENOSYS 88       /**< Function not implemented */
 #define ENAMETOOLONG 91 /**< File or path name too long */
+#define ETIMEDOUT 116   /**< Timed out */
 #define EMSGSIZE 122    /**< Message to long */
 #define EOVERFLOW 139   /**< Numerical overflow */
 
@@ -0,0 +1,75 @@
+/**
+ * @file
+ */
+#ifndef __EVENT_H__
+#define __EVENT_H__
+
+#include <stdint.h>
+#include <time.h>
+
+#define EVENT_WAIT_ANY 0x0   /* Wait for any of the bits to be set */
+#define EVENT_WAIT_ALL 0x1   /* Wait for all of the bits to be set */
+#define EVENT_AUTO_CLEAR 0x2 /* Clear the waited bits after the wake-up */
+
+#define __SIZEOF_EVENT_T 12 /* sizeof(struct event_group) */
+
+typedef union {
+    char __size[__SIZEOF_EVENT_T];
+    uint32_t __align;
+} event_t;
+
+/**
+ * @brief  Initialize the event group with all the 32 event bits cleared
+ * @param  event: Pointer to the event group.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int event_init(event_t *event);
+
+/**
+ * @brief  Destroy the event group
+ * @param  event: Pointer to the event group.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int event_destroy(event_t *event);
+
+/**
+ * @brief  Set the event bits and wake up the threads whose waiting
+ *         conditions are satisfied
+ * @param  event: Pointer to the event group.
+ * @param  bits: The event bits to set.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int event_set(event_t *event, uint32_t bits);
+
+/**
+ * @brief  Clear the event bits
+ * @param  event: Pointer to the event group.
+ * @param  bits: The event bits to clear.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int event_clear(event_t *event, uint32_t bits);
+
+/**
+ * @brief  Get the event bits currently set
+ * @param  event: Pointer to the event group.
+ * @retval uint32_t: The event bits.
+ */
+uint32_t event_get(event_t *event);
+
+/**
+ * @brief  Wait until any or all of the event bits are set
+ * @param  event: Pointer to the event group.
+ * @param  bits: The event bits to wait for. The bits that are set among
+ *         them are returned with the same variable on success.
+ * @param  options: EVENT_WAIT_ANY or EVENT_WAIT_ALL, optionally combined
+ *         with EVENT_AUTO_CLEAR.
+ * @param  timeout: The maximum time to wait, or NULL to wait forever. The
+ *         function returns immediately if the time is zero.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int event_wait(event_t *event,
+               uint32_t *bits,
+               int options,
+               const struct timespec *timeout);
+
+#endif
@@ -20,12 +20,18 @@
 
 #define PTHREAD_PRIO_NONE 0
 #define PTHREAD_PRIO_INHERIT 1
+#define PTHREAD_PRIO_PROTECT 2
 
-#define __SIZEOF_PTHREAD_MUTEXATTR_T 4 /* sizeof(struct mutex_attr) */
-#define __SIZEOF_PTHREAD_MUTEX_T 16    /* sizeof(struct mutex) */
-#define __SIZEOF_PTHREAD_ATTR_T 20     /* sizeof(struct thread_attr) */
-#define __SIZEOF_PTHREAD_COND_T 8      /* sizeof(struct cond) */
-#define __SIZEOF_PTHREAD_ONCE_T 12     /* sizeof(struct thread_once) */
+#define PTHREAD_RWLOCK_PREFER_READER_NP 0
+#define PTHREAD_RWLOCK_PREFER_WRITER_NP 1
+
+#define __SIZEOF_PTHREAD_MUTEXATTR_T 8  /* sizeof(struct mutex_attr) */
+#define __SIZEOF_PTHREAD_MUTEX_T 28     /* sizeof(struct mutex) */
+#define __SIZEOF_PTHREAD_ATTR_T 112     /* sizeof(struct thread_attr), EABI */
+#define __SIZEOF_PTHREAD_COND_T 8       /* sizeof(struct cond) */
+#define __SIZEOF_PTHREAD_ONCE_T 12      /* sizeof(struct thread_once) */
+#define __SIZEOF_PTHREAD_RWLOCKATTR_T 4 /* sizeof(struct rwlock_attr) */
+#define __SIZEOF_PTHREAD_RWLOCK_T 28    /* sizeof(struct rwlock) */
 
 typedef uint32_t pthread_t;
 typedef uint32_t pthread_condattr_t;
@@ -40,9 +46,13 @@ typedef union {
     uint32_t __align;
 } pthread_mutex_t;
 
+/* struct thread_attr holds the 64-bit time_t of struct timespec, which is
+ * 8-byte aligned under the ARM EABI. __SIZEOF_PTHREAD_ATTR_T is the EABI
+ * size, while tools/type_size built with gcc -m32 reports a smaller size as
+ * i386 only aligns int64_t to 4 bytes */
 typedef union {
     char __size[__SIZEOF_PTHREAD_ATTR_T];
-    uint32_t __align;
+    uint64_t __align;
 } pthread_attr_t;
 
 typedef union {
@@ -55,6 +65,16 @@ typedef union {
     uint32_t __align;
 } pthread_once_t;
 
+typedef union {
+    char __size[__SIZEOF_PTHREAD_RWLOCKATTR_T];
+    uint32_t __align;
+} pthread_rwlockattr_t;
+
+typedef union {
+    char __size[__SIZEOF_PTHREAD_RWLOCK_T];
+    uint32_t __align;
+} pthread_rwlock_t;
+
 /**
  * @brief  Initialize a thread attribute object with default values
  * @param  attr: The attribute object to initialize.
@@ -121,6 +141,29 @@ int pthread_mutexattr_setprotocol(pthread_mutexattr_t *attr, int protocol);
 int pthread_mutexattr_getprotocol(const pthread_mutexattr_t *attr,
                                   int *protocol);
 
+/**
+ * @brief  Set the priority ceiling of a mutex attriute object. The ceiling
+ *         is only used by the PTHREAD_PRIO_PROTECT mutexes, whose owner runs
+ *         at the ceiling priority while holding the mutex. The ceiling
+ *         ranges from 0 to THREAD_PRIORITY_MAX, or DL_PRIORITY (see
+ *         kconfig.h) if the mutex is shared with the SCHED_DEADLINE threads,
+ *         which run above all the other user threads
+ * @param  attr: The attribute object to set.
+ * @param  prioceiling: The priority ceiling to set the attribute object.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int pthread_mutexattr_setprioceiling(pthread_mutexattr_t *attr,
+                                     int prioceiling);
+
+/**
+ * @brief  Get the priority ceiling of a mutex attriute object
+ * @param  attr: The attribute object to retrieve the priority ceiling.
+ * @param  prioceiling: For returning the priority ceiling.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int pthread_mutexattr_getprioceiling(const pthread_mutexattr_t *attr,
+                                     int *prioceiling);
+
 /**
  * @brief  Set stack size parameter of a thread attriute object
  * @param  attr: The attribute object to set.
@@ -230,7 +273,10 @@ int pthread_equal(pthread_t t1, pthread_t t2);
  * @brief  Set the scheduling parameters of a thread specified with the thread
  *         ID
  * @param  thread: Thread ID to provide.
- * @param  policy: Not used.
+ * @param  policy: SCHED_DEADLINE for the earliest deadline first scheduling
+ *         with the runtime, deadline and period parameters, fails with
+ *         -EBUSY if the CPU bandwidth is insufficient. The thread uses the
+ *         fixed priority scheduling otherwise.
  * @param  param: The scheduling parameter to set the thread.
  * @retval int: 0 on success and nonzero error number on error.
  */
@@ -242,7 +288,7 @@ int pthread_setschedparam(pthread_t thread,
  * @brief  Get the scheduling parameters of a thread specified with the thread
  *         ID
  * @param  thread: The thread ID to provide.
- * @param  policy: Not used.
+ * @param  policy: For returning the scheduling policy of the thread.
  * @param  param: For returning the scheduling parameter from the thread.
  * @retval int: 0 on success and nonzero error number on error.
  */
@@ -325,6 +371,27 @@ int pthread_mutex_lock(pthread_mutex_t *mutex);
  */
 int pthread_mutex_trylock(pthread_mutex_t *mutex);
 
+/**
+ * @brief  Change the priority ceiling of the mutex. The mutex is locked
+ *         during the change
+ * @param  mutex: The mutex to set.
+ * @param  prioceiling: The new priority ceiling.
+ * @param  old_ceiling: For returning the old priority ceiling, can be NULL.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int pthread_mutex_setprioceiling(pthread_mutex_t *mutex,
+                                 int prioceiling,
+                                 int *old_ceiling);
+
+/**
+ * @brief  Get the priority ceiling of the mutex
+ * @param  mutex: The mutex to retrieve the priority ceiling.
+ * @param  prioceiling: For returning the priority ceiling.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int pthread_mutex_getprioceiling(const pthread_mutex_t *mutex,
+                                 int *prioceiling);
+
 /**
  * @brief  Initialize the attribute object of conditional variable with
  *         default values
@@ -388,4 +455,100 @@ int pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex);
  */
 int pthread_once(pthread_once_t *once_control, void (*init_routine)(void));
 
+/**
+ * @brief  Initialize the attribute object of reader-writer lock with default
+ *         values
+ * @param  attr: The attribute object of the reader-writer lock to initialize.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int pthread_rwlockattr_init(pthread_rwlockattr_t *attr);
+
+/**
+ * @brief  Destroy the attribute object of reader-writer lock
+ * @param  attr: The attribute object of the reader-writer lock to destroy.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int pthread_rwlockattr_destroy(pthread_rwlockattr_t *attr);
+
+/**
+ * @brief  Set the preference of a reader-writer lock attribute object. With
+ *         PTHREAD_RWLOCK_PREFER_READER_NP (default), the lock is handed to
+ *         the side with the highest-priority waiting thread, and the readers
+ *         win the tie. With PTHREAD_RWLOCK_PREFER_WRITER_NP, the readers
+ *         always wait while a writer is waiting
+ * @param  attr: The attribute object to set.
+ * @param  pref: The preference to set the attribute object.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int pthread_rwlockattr_setkind_np(pthread_rwlockattr_t *attr, int pref);
+
+/**
+ * @brief  Get the preference of a reader-writer lock attribute object
+ * @param  attr: The attribute object to retrieve the preference.
+ * @param  pref: For returning the preference.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int pthread_rwlockattr_getkind_np(const pthread_rwlockattr_t *attr,
+                                  int *pref);
+
+/**
+ * @brief  Initialize the reader-writer lock
+ * @param  rwlock: The reader-writer lock to initialize.
+ * @param  attr: The attribute object for initializing the reader-writer lock,
+ *         or NULL for the default attributes.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int pthread_rwlock_init(pthread_rwlock_t *rwlock,
+                        const pthread_rwlockattr_t *attr);
+
+/**
+ * @brief  Destroy the reader-writer lock
+ * @param  rwlock: The reader-writer lock to destroy.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int pthread_rwlock_destroy(pthread_rwlock_t *rwlock);
+
+/**
+ * @brief  Lock the reader-writer lock for reading. The lock can be held by
+ *         multiple readers at the same time, and by the same reader multiple
+ *         times. The writer of the lock gets -EDEADLK, and -EAGAIN is
+ *         returned if the thread already holds RWLOCK_READ_MAX other locks
+ *         for reading
+ * @param  rwlock: The reader-writer lock to lock.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int pthread_rwlock_rdlock(pthread_rwlock_t *rwlock);
+
+/**
+ * @brief  Lock the reader-writer lock for reading. If the lock can't be
+ *         acquired immediately then the function shall return with -EBUSY
+ * @param  rwlock: The reader-writer lock to lock.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int pthread_rwlock_tryrdlock(pthread_rwlock_t *rwlock);
+
+/**
+ * @brief  Lock the reader-writer lock for writing. The lock is exclusively
+ *         held by the writer
+ * @param  rwlock: The reader-writer lock to lock.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int pthread_rwlock_wrlock(pthread_rwlock_t *rwlock);
+
+/**
+ * @brief  Lock the reader-writer lock for writing. If the lock can't be
+ *         acquired immediately then the function shall return with -EBUSY
+ * @param  rwlock: The reader-writer lock to lock.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int pthread_rwlock_trywrlock(pthread_rwlock_t *rwlock);
+
+/**
+ * @brief  Unlock the reader-writer lock held by the calling thread. -EPERM
+ *         is returned if the calling thread doesn't hold the lock
+ * @param  rwlock: The reader-writer lock to unlock.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int pthread_rwlock_unlock(pthread_rwlock_t *rwlock);
+
 #endif
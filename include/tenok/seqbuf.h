@@ -0,0 +1,51 @@
+/**
+ * @file
+ */
+#ifndef __SEQBUF_H__
+#define __SEQBUF_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define __SIZEOF_SEQBUF_T 12 /* sizeof(struct seqbuf) */
+
+/* Declare the storage of the double buffer for values of the given type */
+#define SEQBUF_STORAGE(name, type) type name[2]
+
+typedef union {
+    char __size[__SIZEOF_SEQBUF_T];
+    uint32_t __align;
+} seqbuf_t;
+
+/**
+ * @brief  Initialize the double buffer for sharing the latest value from a
+ *         single writer thread to any number of reader threads without
+ *         locking. Both copies of the storage are cleared
+ * @param  seqbuf: Pointer to the double buffer.
+ * @param  storage: The storage of at least 2 * size bytes, e.g., declared
+ *         with SEQBUF_STORAGE().
+ * @param  size: Size of the value in bytes.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int seqbuf_init(seqbuf_t *seqbuf, void *storage, size_t size);
+
+/**
+ * @brief  Publish a new value. The writer never blocks, but only one
+ *         thread is allowed to write the same double buffer
+ * @param  seqbuf: Pointer to the double buffer.
+ * @param  value: The new value to publish.
+ * @retval None
+ */
+void seqbuf_write(seqbuf_t *seqbuf, const void *value);
+
+/**
+ * @brief  Read the latest published value. The reader never waits for the
+ *         writer and only retries if a new value was published during the
+ *         read
+ * @param  seqbuf: Pointer to the double buffer.
+ * @param  value: For returning the value.
+ * @retval None
+ */
+void seqbuf_read(seqbuf_t *seqbuf, void *value);
+
+#endif
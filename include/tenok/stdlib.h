@@ -60,6 +60,15 @@ char *utoa(unsigned int value, char *buffer, int radix);
 char *ltoa(long value, char *buffer, int radix);
 char *ultoa(unsigned long value, char *buffer, int radix);
 
+/**
+ * @brief  Get the 1, 10 and 60 seconds CPU load averages. The load is the
+ *         fraction of the time that the CPU was not idle
+ * @param  loadavg: The array for returning the load averages.
+ * @param  nelem: The number of the load averages to get (up to 3).
+ * @retval int: The number of the load averages returned.
+ */
+int getloadavg(double loadavg[], int nelem);
+
 /*
  * Functions provided by the compiler:
  */
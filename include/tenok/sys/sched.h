@@ -4,13 +4,34 @@
 #ifndef __SYS_SCHED_H__
 #define __SYS_SCHED_H__
 
+#include <time.h>
+
 #define SCHED_FIFO 1
 #define SCHED_RR 2
 #define SCHED_OTHER 3
 #define SCHED_SPORADIC 4
+#define SCHED_DEADLINE 6
 
 struct sched_param {
     int sched_priority;
+
+    /* SCHED_SPORADIC: The thread runs with sched_priority until the budget
+     * is exhausted, then it is suspended until the budget is replenished.
+     * The budget consumed since the thread became runnable is replenished
+     * sched_ss_repl_period later, with at most sched_ss_max_repl pending
+     * replenishments. sched_ss_low_priority is not used */
+    int sched_ss_low_priority;
+    int sched_ss_max_repl;
+    struct timespec sched_ss_repl_period;
+    struct timespec sched_ss_init_budget;
+
+    /* SCHED_DEADLINE: The thread is given sched_runtime of the CPU time
+     * every sched_period, which must be consumed within sched_deadline
+     * after the period started. sched_deadline equals to sched_period if
+     * it is set to zero */
+    struct timespec sched_runtime;
+    struct timespec sched_deadline;
+    struct timespec sched_period;
 };
 
 #endif
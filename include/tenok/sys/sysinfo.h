@@ -0,0 +1,25 @@
+/**
+ * @file
+ */
+#ifndef __SYSINFO_H__
+#define __SYSINFO_H__
+
+#define SI_LOAD_SHIFT 16
+
+struct sysinfo {
+    long uptime;             /* Seconds since boot */
+    unsigned long loads[3];  /* 1, 10 and 60 seconds CPU load averages */
+    unsigned short procs;    /* Number of current threads */
+    unsigned long cpu_freq;  /* Clock frequency of the CPU in Hz */
+};
+
+/**
+ * @brief  Return the overall system statistics. The load averages are the
+ *         fraction of the time the CPU was not idle, in the fixed-point
+ *         format with SI_LOAD_SHIFT fractional bits
+ * @param  info: The sysinfo object for returning the statistics.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int sysinfo(struct sysinfo *info);
+
+#endif
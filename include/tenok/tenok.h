@@ -8,6 +8,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <sys/types.h>
+#include <time.h>
 
 #include "kconfig.h"
 
@@ -15,6 +16,12 @@ struct thread_stat {
     int pid;
     int tid;
     int priority;
+    int policy;
+    uint32_t dl_misses;    /* Deadline misses of the SCHED_DEADLINE thread */
+    uint32_t throttle_cnt; /* Times the thread exhausted its CPU budget */
+    uint64_t cpu_time;     /* CPU time consumed by the thread in ns */
+    uint32_t nvcsw;        /* Number of voluntary context switches */
+    uint32_t nivcsw;       /* Number of involuntary context switches */
     char *status;
     bool kernel_thread;
     size_t stack_usage;
@@ -22,6 +29,12 @@ struct thread_stat {
     char name[THREAD_NAME_MAX];
 };
 
+struct period_info {
+    struct timespec next_period; /* Absolute start time of the next period */
+    struct timespec period;      /* Length of the period */
+    uint32_t overruns;           /* Total number of the missed periods */
+};
+
 enum {
     PAGE_TOTAL_SIZE = 0,
     PAGE_FREE_SIZE = 1,
@@ -46,6 +59,13 @@ void sched_start(void);
  */
 void *thread_info(struct thread_stat *info, void *next);
 
+/**
+ * @brief  Get the CPU time consumed by the calling thread
+ * @param  tp: The time object for returning the CPU time.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int thread_cputime(struct timespec *tp);
+
 /**
  * @brief  Set the name of the running thread
  * @param  name: The name of the program.
@@ -60,6 +80,25 @@ void setprogname(const char *name);
  */
 int delay_ticks(uint32_t ticks);
 
+/**
+ * @brief  Start the periodic execution of the calling thread from now on
+ * @param  pinfo: The period information to initialize.
+ * @param  period_ns: The period in nanoseconds.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int period_init(struct period_info *pinfo, long period_ns);
+
+/**
+ * @brief  Sleep until the start of the next period. The wake-up times are
+ *         calculated with the absolute time, hence the execution time of the
+ *         loop body does not accumulate as drift. The periods already missed
+ *         are skipped instead of being executed back-to-back
+ * @param  pinfo: The period information initialized by period_init().
+ * @retval int: The number of periods missed since the last call on success
+ *         and nonzero error number on error.
+ */
+int period_wait(struct period_info *pinfo);
+
 /**
  * @brief  Get memory information of the system
  * @param  name: The information to acquire (check MINFO_NAMES).
@@ -10,6 +10,9 @@
 
 #define CLOCK_REALTIME 0
 #define CLOCK_MONOTONIC 1
+#define CLOCK_THREAD_CPUTIME_ID 3
+
+#define TIMER_ABSTIME 1
 
 struct timespec {
     time_t tv_sec; /* Seconds */
@@ -38,13 +41,41 @@ int clock_getres(clockid_t clockid, struct timespec *res);
 int clock_gettime(clockid_t clockid, struct timespec *tp);
 
 /**
- * @brief  Set the time of the specified clock ID
+ * @brief  Set the time of the specified clock ID. Only CLOCK_REALTIME can
+ *         be set, CLOCK_MONOTONIC is not affected by the change
  * @param  clk_id: The clock ID to provide.
  * @param  tp: The time object for setting the clock.
  * @retval int: 0 on success and nonzero error number on error.
  */
 int clock_settime(clockid_t clockid, const struct timespec *tp);
 
+/**
+ * @brief  Suspend the calling thread until the given time interval elapsed
+ *         or the given absolute time is reached
+ * @param  clk_id: The clock ID to provide.
+ * @param  flags: 0 for the relative interval or TIMER_ABSTIME for the
+ *         absolute time of the clock.
+ * @param  req: The time interval or the absolute time to sleep until.
+ * @param  rem: For returning the remaining time of the relative sleep,
+ *         which is always zero since the sleep is not interruptible by
+ *         signals. Can be NULL.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int clock_nanosleep(clockid_t clockid,
+                    int flags,
+                    const struct timespec *req,
+                    struct timespec *rem);
+
+/**
+ * @brief  Suspend the calling thread until the given time interval elapsed
+ *         with the resolution of the high-resolution timer
+ * @param  req: The time interval to sleep.
+ * @param  rem: For returning the remaining time, which is always zero since
+ *         the sleep is not interruptible by signals. Can be NULL.
+ * @retval int: 0 on success and nonzero error number on error.
+ */
+int nanosleep(const struct timespec *req, struct timespec *rem);
+
 /**
  * @brief  Create a new per-thread interval timer
  * @param  clk_id: The clock ID to provide.
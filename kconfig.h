@@ -9,6 +9,18 @@
 #define OS_TICK_FREQ 100 /* Hz */
 #endif
 
+/* Time slice of the SCHED_RR threads */
+#define SCHED_RR_TIMESLICE 4 /* Ticks */
+
+/* 1: Stop the periodic tick when the system is idle, 0: Always tick */
+#define USE_TICKLESS_IDLE 1
+
+/* Max total CPU utilization of the SCHED_DEADLINE threads */
+#define DL_UTIL_MAX 90 /* Percent */
+
+/* Max number of pending budget replenishments of a SCHED_SPORADIC thread */
+#define SS_REPL_MAX 4
+
 /* Page allocator size */
 #define PAGE_SIZE_32K 0 /* Use 32 KiB */
 #define PAGE_SIZE_64K 1 /* Use 64 KiB */
@@ -32,6 +44,17 @@
 #define THREAD_NAME_MAX 50    /* Max length of thread names */
 #define THREAD_MAX 64         /* Max number of threads in the system */
 
+/* Max number of reader-writer locks a thread can hold for reading */
+#define RWLOCK_READ_MAX 4
+
+/* SCHED_DEADLINE threads share the priority level above all user threads
+ * but below the kernel threads, and are ordered by their deadlines. It is
+ * also the highest priority ceiling of the PTHREAD_PRIO_PROTECT mutexes */
+#define DL_PRIORITY (THREAD_PRIORITY_MAX + 1)
+
+/* Timer */
+#define TIMER_WHEEL_SIZE 64 /* Number of the timer wheel buckets */
+
 /* Message queue and pipe */
 #define MQUEUE_MAX 50  /* Max number of message queue can be allocated */
 #define _MQ_PRIO_MAX 5 /* Max message queue priority number */
@@ -95,6 +95,19 @@ void jump_to_kernel(void)
         __preempt_disable();
 }
 
+void request_context_switch(void)
+{
+    /* No need to trigger the PendSV if the kernel loop is running already
+     * since it will do the rescheduling before jumping to the thread */
+    uint32_t mode = get_proc_mode();
+    if (mode == (SVCall_IRQn + 16) || mode == (PendSV_IRQn + 16))
+        return;
+
+    /* Jump to the kernel loop via PendSV exception once the preemption is
+     * enabled */
+    SCB->ICSR |= SCB_ICSR_PENDSVSET_Msk;
+}
+
 void __stack_init(uint32_t **stack_top,
                   uint32_t func,
                   uint32_t return_handler,
@@ -129,6 +142,59 @@ void __stack_init(uint32_t **stack_top,
      */
 }
 
+static uint32_t apb1_timer_clock;
+
+static void apb1_timer_clock_init(void)
+{
+    /* Timers on the APB1 are clocked twice as fast as the bus if the APB1
+     * prescaler is not 1 */
+    RCC_ClocksTypeDef clocks;
+    RCC_GetClocksFreq(&clocks);
+    apb1_timer_clock = clocks.PCLK1_Frequency;
+    if (clocks.PCLK1_Frequency != clocks.HCLK_Frequency)
+        apb1_timer_clock *= 2;
+}
+
+static void clocksource_init(void)
+{
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM5, ENABLE);
+
+    /* Free-running 32-bit counter with the full timer clock */
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStruct = {
+        .TIM_Period = UINT32_MAX,
+        .TIM_Prescaler = 0,
+        .TIM_ClockDivision = TIM_CKD_DIV1,
+        .TIM_CounterMode = TIM_CounterMode_Up,
+    };
+    TIM_TimeBaseInit(TIM5, &TIM_TimeBaseInitStruct);
+    TIM_Cmd(TIM5, ENABLE);
+}
+
+static void hrtimer_init(void)
+{
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, ENABLE);
+
+    /* Count with 1MHz and stop automatically on the update event */
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStruct = {
+        .TIM_Period = UINT32_MAX,
+        .TIM_Prescaler = apb1_timer_clock / 1000000 - 1,
+        .TIM_ClockDivision = TIM_CKD_DIV1,
+        .TIM_CounterMode = TIM_CounterMode_Up,
+    };
+    TIM_TimeBaseInit(TIM2, &TIM_TimeBaseInitStruct);
+    TIM_SelectOnePulseMode(TIM2, TIM_OPMode_Single);
+    TIM_UpdateRequestConfig(TIM2, TIM_UpdateSource_Regular);
+
+    /* Clear the update event generated by the initialization */
+    TIM_ClearITPendingBit(TIM2, TIM_IT_Update);
+    TIM_ITConfig(TIM2, TIM_IT_Update, ENABLE);
+
+    /* Same priority as the SysTick so it is masked by the preemption
+     * disabling */
+    NVIC_SetPriority(TIM2_IRQn, 1);
+    NVIC_EnableIRQ(TIM2_IRQn);
+}
+
 void __platform_init(void)
 {
     /* Priority range of group 4 is 0-15 */
@@ -140,6 +206,11 @@ void __platform_init(void)
     NVIC_SetPriority(SVCall_IRQn, 15);
     NVIC_SetPriority(PendSV_IRQn, 15);
 
+    /* Initialize the clocksource and the high-resolution timer */
+    apb1_timer_clock_init();
+    clocksource_init();
+    hrtimer_init();
+
     /* Enable SysTick timer */
     SysTick_Config(SystemCoreClock / OS_TICK_FREQ);
 
@@ -190,6 +261,106 @@ void __idle(void)
     asm volatile("wfi");
 }
 
+uint32_t __idle_ticks(uint32_t ticks)
+{
+    uint32_t tick_reload = SystemCoreClock / OS_TICK_FREQ;
+
+    /* The SysTick counter is only 24 bits wide */
+    uint32_t max_ticks = SysTick_LOAD_RELOAD_Msk / tick_reload;
+    if (ticks > max_ticks)
+        ticks = max_ticks;
+
+    /* Interrupts are masked by PRIMASK instead of BASEPRI from now on, so
+     * the WFI instruction can still be woken up by them */
+    __disable_irq();
+
+    /* Stop the SysTick and read the cycles left for the current tick */
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    uint32_t tick_remained = SysTick->VAL;
+
+    /* Give up if the current tick has expired already */
+    if ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) || tick_remained == 0) {
+        SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+        __enable_irq();
+        return 0;
+    }
+
+    /* Reprogram the SysTick to expire at the end of the last tick */
+    uint32_t idle_cycles = tick_remained + tick_reload * (ticks - 1);
+    SysTick->LOAD = idle_cycles - 1;
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+    /* Idle until the SysTick or any other interrupt arrives */
+    __set_BASEPRI(0);
+    __DSB();
+    __WFI();
+    __ISB();
+    __preempt_disable();
+
+    /* Stop the SysTick again (reading the CTRL also clears the COUNTFLAG) */
+    uint32_t ctrl = SysTick->CTRL;
+    SysTick->CTRL = ctrl & ~SysTick_CTRL_ENABLE_Msk;
+
+    uint32_t elapsed_ticks, next_tick_cycles;
+    if (ctrl & SysTick_CTRL_COUNTFLAG_Msk) {
+        /* Woken up by the SysTick, the pending tick handler will handle the
+         * last tick */
+        elapsed_ticks = ticks - 1;
+        next_tick_cycles = tick_reload;
+    } else {
+        /* Woken up by other interrupts, calculate the passed ticks and the
+         * cycles left for the current tick */
+        uint32_t cycles_left = SysTick->VAL;
+        uint32_t elapsed_cycles = idle_cycles - cycles_left;
+        elapsed_ticks = (elapsed_cycles >= tick_remained)
+                            ? 1 + (elapsed_cycles - tick_remained) / tick_reload
+                            : 0;
+        next_tick_cycles = cycles_left % tick_reload;
+        if (next_tick_cycles == 0)
+            next_tick_cycles = tick_reload;
+    }
+
+    /* Restart the SysTick for the current tick then restore the reload value
+     * for the periodic ticks afterward */
+    SysTick->LOAD = next_tick_cycles - 1;
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD = tick_reload - 1;
+
+    __enable_irq();
+
+    return elapsed_ticks;
+}
+
+uint32_t __clocksource_read(void)
+{
+    return TIM5->CNT;
+}
+
+uint32_t __clocksource_freq(void)
+{
+    return apb1_timer_clock;
+}
+
+uint32_t __cpu_freq(void)
+{
+    return SystemCoreClock;
+}
+
+void __hrtimer_start(uint32_t usec)
+{
+    if (usec == 0)
+        usec = 1;
+
+    /* Count from 1 so the update event happens after exactly usec ticks */
+    TIM2->CR1 &= ~TIM_CR1_CEN;
+    TIM2->CNT = 1;
+    TIM2->ARR = usec;
+    TIM2->SR = ~TIM_SR_UIF;
+    TIM2->CR1 |= TIM_CR1_CEN;
+}
+
 void halt(void)
 {
     preempt_disable();
@@ -293,7 +464,14 @@ NACKED void UsageFault_Handler(void)
 void SysTick_Handler(void)
 {
     system_ticks_update();
-    jump_to_kernel();
+}
+
+void TIM2_IRQHandler(void)
+{
+    if (TIM2->SR & TIM_SR_UIF) {
+        TIM2->SR = ~TIM_SR_UIF;
+        system_hrtimer_update();
+    }
 }
 
 void NMI_Handler(void)
@@ -0,0 +1,173 @@
+#include <errno.h>
+#include <event.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <arch/port.h>
+#include <common/list.h>
+#include <kernel/event.h>
+#include <kernel/kernel.h>
+#include <kernel/preempt.h>
+#include <kernel/sched.h>
+#include <kernel/syscall.h>
+#include <kernel/thread.h>
+#include <kernel/time.h>
+#include <kernel/wait.h>
+
+void event_group_init(struct event_group *group)
+{
+    group->bits = 0;
+    INIT_LIST_HEAD(&group->wait_list);
+}
+
+static bool event_satisfied(uint32_t set_bits, uint32_t bits, int options)
+{
+    if (options & EVENT_WAIT_ALL)
+        return (set_bits & bits) == bits;
+    else
+        return (set_bits & bits) != 0;
+}
+
+void event_group_set(struct event_group *group, uint32_t bits)
+{
+    preempt_disable();
+
+    group->bits |= bits;
+
+    /* Wake up all the threads whose conditions are satisfied. The bits to
+     * clear are collected first so every waiter sees the same bits */
+    uint32_t clear_bits = 0;
+
+    struct list_head *curr, *next;
+    list_for_each_safe (curr, next, &group->wait_list) {
+        struct thread_info *thread = list_entry(curr, struct thread_info, list);
+
+        if (!event_satisfied(group->bits, thread->event_bits,
+                             thread->event_options))
+            continue;
+
+        if (thread->event_options & EVENT_AUTO_CLEAR)
+            clear_bits |= thread->event_bits;
+
+        /* Return the bits that are set to the waiting thread */
+        thread->event_bits &= group->bits;
+
+        /* Stop the timeout so the delivered event can't be reported as
+         * timed out if the tick comes before the thread runs */
+        list_del_init(&thread->timeout_list);
+        finish_wait(thread);
+    }
+
+    group->bits &= ~clear_bits;
+
+    preempt_enable();
+}
+
+void event_group_clear(struct event_group *group, uint32_t bits)
+{
+    preempt_disable();
+    group->bits &= ~bits;
+    preempt_enable();
+}
+
+int event_group_wait(struct event_group *group,
+                     uint32_t *bits,
+                     int options,
+                     const struct timespec *timeout)
+{
+    preempt_disable();
+
+    int retval;
+
+    CURRENT_THREAD_INFO(curr_thread);
+
+    if (*bits == 0) {
+        retval = -EINVAL;
+        goto leave;
+    }
+
+    /* Return immediately if the condition is satisfied already */
+    if (event_satisfied(group->bits, *bits, options)) {
+        *bits &= group->bits;
+        if (options & EVENT_AUTO_CLEAR)
+            group->bits &= ~*bits;
+
+        retval = 0;
+        goto leave;
+    }
+
+    /* Don't wait if the timeout is zero */
+    uint32_t ticks = timeout ? timespec_to_ticks(timeout) : 0;
+    if (timeout && ticks == 0) {
+        retval = -EAGAIN;
+        goto leave;
+    }
+
+    /* Wait until the condition is satisfied by event_group_set() */
+    curr_thread->event_bits = *bits;
+    curr_thread->event_options = options;
+
+    if (timeout)
+        prepare_to_wait_timeout(&group->wait_list, curr_thread, THREAD_WAIT,
+                                ticks);
+    else
+        prepare_to_wait(&group->wait_list, curr_thread, THREAD_WAIT);
+
+    schedule();
+
+    if (timeout && finish_wait_timeout(curr_thread)) {
+        retval = -ETIMEDOUT;
+        goto leave;
+    }
+
+    /* Return the bits that woke up the thread */
+    *bits = curr_thread->event_bits;
+    retval = 0;
+
+leave:
+    preempt_enable();
+    return retval;
+}
+
+int event_init(event_t *event)
+{
+    if (!event)
+        return -ENOMEM;
+
+    event_group_init((struct event_group *) event);
+    return 0;
+}
+
+int event_destroy(event_t *event)
+{
+    if (!event)
+        return -ENOMEM;
+
+    memset(event, 0, sizeof(event_t));
+    return 0;
+}
+
+uint32_t event_get(event_t *event)
+{
+    /* Reading a single word is atomic, no need to enter the kernel */
+    return ((struct event_group *) event)->bits;
+}
+
+NACKED int event_set(event_t *event, uint32_t bits)
+{
+    SYSCALL(EVENT_SET);
+}
+
+NACKED int event_clear(event_t *event, uint32_t bits)
+{
+    SYSCALL(EVENT_CLEAR);
+}
+
+NACKED int event_wait(event_t *event,
+                      uint32_t *bits,
+                      int options,
+                      const struct timespec *timeout)
+{
+    SYSCALL(EVENT_WAIT);
+}
@@ -1,5 +1,6 @@
 #include <dirent.h>
 #include <errno.h>
+#include <event.h>
 #include <fcntl.h>
 #include <mpool.h>
 #include <mqueue.h>
@@ -15,6 +16,7 @@
 #include <sys/limits.h>
 #include <sys/mount.h>
 #include <sys/stat.h>
+#include <sys/sysinfo.h>
 #include <task.h>
 #include <tenok.h>
 #include <time.h>
@@ -29,6 +31,7 @@
 #include <fs/rom_dev.h>
 #include <kernel/daemon.h>
 #include <kernel/errno.h>
+#include <kernel/event.h>
 #include <kernel/kernel.h>
 #include <kernel/kfifo.h>
 #include <kernel/mqueue.h>
@@ -36,6 +39,7 @@
 #include <kernel/pipe.h>
 #include <kernel/preempt.h>
 #include <kernel/printk.h>
+#include <kernel/rwlock.h>
 #include <kernel/sched.h>
 #include <kernel/semaphore.h>
 #include <kernel/signal.h>
@@ -51,21 +55,43 @@
 
 #include "kconfig.h"
 
-#define PRI_RESERVED 2
+#define PRI_RESERVED 3
 #define KTHREAD_PRI_MAX (THREAD_PRIORITY_MAX + PRI_RESERVED)
 
+/* Fixed-point unit of the CPU bandwidth (1.0) */
+#define DL_BW_UNIT (1 << 20)
+
+/* Fixed-point unit of the CPU load (1.0) */
+#define LOAD_FIXED_1 (1 << SI_LOAD_SHIFT)
+
+struct dl_params {
+    uint32_t runtime;  /* Ticks */
+    uint32_t deadline; /* Ticks */
+    uint32_t period;   /* Ticks */
+    uint32_t bw;       /* Fraction of DL_BW_UNIT */
+};
+
 static LIST_HEAD(tasks_list);   /* List of all tasks in the system */
 static LIST_HEAD(threads_list); /* List of all threads in the system */
 static LIST_HEAD(sleep_list);   /* List of all threads in the sleeping state */
+static LIST_HEAD(hrsleep_list); /* List of all threads sleeping on hrtimer */
 static LIST_HEAD(suspend_list); /* List of all threads that are suspended */
 static LIST_HEAD(timeout_list); /* List of all blocked threads with timeout */
-static LIST_HEAD(timers_list);  /* List of all timers in the system */
 static LIST_HEAD(poll_list);    /* List of all threads suspended by poll() */
 static LIST_HEAD(mqueue_list);  /* List of all posix message queues */
 
 /* Lists of all threads in ready state */
 struct list_head ready_list[KTHREAD_PRI_MAX + 1];
 
+/* Bitmap of non-empty ready lists (bit n stands for ready_list[n]) */
+static uint32_t ready_bitmap;
+
+/* Total CPU bandwidth reserved by the SCHED_DEADLINE threads */
+static uint32_t dl_total_bw;
+
+/* Hashed timer wheel of all armed timers indexed by the expiration tick */
+static struct list_head timer_wheel[TIMER_WHEEL_SIZE];
+
 /* Scheduler */
 static bool need_resched_flag;
 static uint32_t preempt_cnt;
@@ -78,12 +104,20 @@ static struct task_struct tasks[TASK_MAX];
 
 static struct thread_info threads[THREAD_MAX];
 static struct thread_info *running_thread;
+static uint32_t cputime_stamp; /* Clocksource count of the last accounting */
+
+/* CPU load averages */
+static uint32_t loadavg[3];          /* In the SI_LOAD_SHIFT fixed point */
+static uint32_t loadavg_next_tick;   /* Absolute tick of the next sample */
+static uint32_t loadavg_stamp;       /* Clocksource count of the last sample */
+static uint64_t loadavg_idle_cycles; /* Idle cycles of the last sample */
 
 static uint32_t bitmap_tasks[BITMAP_SIZE(TASK_MAX)];
 static uint32_t bitmap_threads[BITMAP_SIZE(THREAD_MAX)];
 
 /* Daemons information */
 static int daemon_id_table[DAEMON_CNT];
+static struct thread_info *daemon_thread_table[DAEMON_CNT];
 
 #define DECLARE_DAEMON(x) #x
 static char *deamon_names[] = {DAEMON_LIST};
@@ -178,6 +212,21 @@ void preempt_count_set(uint32_t count)
     preempt_cnt = count;
 }
 
+static inline void set_need_resched(void)
+{
+    need_resched_flag = true;
+}
+
+static inline void reset_need_resched(void)
+{
+    need_resched_flag = false;
+}
+
+static inline bool need_resched(void)
+{
+    return need_resched_flag;
+}
+
 void *kmalloc(size_t size)
 {
     /* Start the critcal section */
@@ -274,24 +323,90 @@ inline struct thread_info *current_thread_info(void)
 
 static struct task_struct *acquire_task(int pid)
 {
-    struct task_struct *task;
-    list_for_each_entry (task, &tasks_list, list) {
-        if (task->pid == pid)
-            return task;
-    }
+    /* The task ID is the index of the task array */
+    if (pid < 0 || pid >= TASK_MAX || !bitmap_get_bit(bitmap_tasks, pid))
+        return NULL;
 
-    return NULL;
+    return &tasks[pid];
 }
 
-struct thread_info *acquire_thread(int tid)
+static void cputime_update(void)
 {
-    struct thread_info *thread;
-    list_for_each_entry (thread, &threads_list, thread_list) {
-        if (thread->tid == tid)
-            return thread;
+    /* Charge the CPU time since the last accounting to the running thread.
+     * It is also called at every tick so the clocksource can't wrap around
+     * between two accountings */
+    uint32_t now = __clocksource_read();
+    running_thread->cpu_cycles += now - cputime_stamp;
+    cputime_stamp = now;
+}
+
+static void loadavg_update(void)
+{
+    /* exp(-1 / n) in the SI_LOAD_SHIFT fixed point for averaging the load
+     * over 1, 10 and 60 seconds */
+    static const uint32_t decay[3] = {24109, 59299, 64453};
+
+    /* Sample the load every second */
+    uint32_t now = get_sys_ticks();
+    if (time_before(now, loadavg_next_tick))
+        return;
+
+    /* The load is the fraction of the time that the idle thread (which
+     * always has the thread ID 0) was not running since the last sample */
+    uint32_t elapsed = cputime_stamp - loadavg_stamp;
+    uint64_t idle = threads[0].cpu_cycles - loadavg_idle_cycles;
+    uint32_t busy = elapsed > idle ? elapsed - (uint32_t) idle : 0;
+    uint32_t sample =
+        elapsed ? ((uint64_t) busy << SI_LOAD_SHIFT) / elapsed : 0;
+
+    loadavg_stamp = cputime_stamp;
+    loadavg_idle_cycles = threads[0].cpu_cycles;
+
+    /* Decay once for every second passed as the ticks may be skipped by the
+     * tickless idle */
+    uint32_t seconds = (now - loadavg_next_tick) / OS_TICK_FREQ + 1;
+    loadavg_next_tick += seconds * OS_TICK_FREQ;
+
+    for (int i = 0; i < 3; i++) {
+        for (uint32_t j = 0; j < seconds; j++) {
+            uint64_t load = (uint64_t) loadavg[i] * decay[i] +
+                            (uint64_t) sample * (LOAD_FIXED_1 - decay[i]);
+            loadavg[i] = load >> SI_LOAD_SHIFT;
+        }
     }
+}
 
-    return NULL;
+static uint64_t thread_cputime_ns(struct thread_info *thread)
+{
+    if (thread == running_thread)
+        cputime_update();
+
+    uint32_t mhz = __clocksource_freq() / 1000000;
+    return thread->cpu_cycles * 1000 / mhz;
+}
+
+/* The thread ID returned to the user combines the generation counter of the
+ * thread control block and the index of the thread array */
+static inline pthread_t thread_id(struct thread_info *thread)
+{
+    return ((pthread_t) thread->gen << 16) | thread->tid;
+}
+
+struct thread_info *acquire_thread(pthread_t tid)
+{
+    uint32_t idx = tid & 0xffff;
+
+    /* Check if the thread exists */
+    if (idx >= THREAD_MAX || !bitmap_get_bit(bitmap_threads, idx))
+        return NULL;
+
+    /* Check if the thread ID is stale, i.e., the thread control block is
+     * reused by another thread */
+    struct thread_info *thread = &threads[idx];
+    if (thread->gen != (tid >> 16))
+        return NULL;
+
+    return thread;
 }
 
 void set_daemon_id(int daemon)
@@ -304,6 +419,7 @@ void set_daemon_id(int daemon)
     }
 
     daemon_id_table[daemon] = running_thread->tid;
+    daemon_thread_table[daemon] = running_thread;
 
     preempt_enable();
 }
@@ -313,6 +429,472 @@ uint16_t get_daemon_id(int daemon)
     return daemon_id_table[daemon];
 }
 
+struct thread_info *get_daemon_thread(int daemon)
+{
+    return daemon_thread_table[daemon];
+}
+
+/* Start a new job for the waking deadline thread unless the budget left can
+ * still be consumed before the current deadline without exceeding the
+ * reserved bandwidth (wake-up rule of the constant bandwidth server) */
+static void dl_wakeup(struct thread_info *thread)
+{
+    uint32_t now = get_sys_ticks();
+
+    if (time_before(now, thread->dl_abs_deadline) &&
+        (uint64_t) thread->dl_budget * thread->dl_period <=
+            (uint64_t) (thread->dl_abs_deadline - now) * thread->dl_runtime)
+        return;
+
+    thread->dl_abs_deadline = now + thread->dl_deadline;
+    thread->dl_budget = thread->dl_runtime;
+    thread->dl_missed = false;
+}
+
+/* Check if thread a should run before thread b on the deadline level */
+static bool dl_before(struct thread_info *a, struct thread_info *b)
+{
+    /* Threads boosted to the level by priority inheritance go first */
+    if (b->sched_policy != SCHED_DEADLINE)
+        return false;
+    if (a->sched_policy != SCHED_DEADLINE)
+        return true;
+
+    /* Earliest deadline first */
+    return time_before(a->dl_abs_deadline, b->dl_abs_deadline);
+}
+
+/* Apply the pending replenishments of the sporadic server thread that are
+ * due by now */
+static void ss_replenish(struct thread_info *thread, uint32_t now)
+{
+    /* Pending replenishments are ordered by their ticks */
+    while (thread->ss_repl_cnt > 0 &&
+           time_after_eq(now, thread->ss_repl[0].tick)) {
+        thread->ss_budget += thread->ss_repl[0].amount;
+        thread->ss_repl_cnt--;
+        memmove(&thread->ss_repl[0], &thread->ss_repl[1],
+                sizeof(struct ss_repl) * thread->ss_repl_cnt);
+    }
+
+    /* The budget overrun while holding a lock is also replenished later */
+    if (thread->ss_budget > thread->ss_init_budget)
+        thread->ss_budget = thread->ss_init_budget;
+}
+
+static void ss_activate(struct thread_info *thread)
+{
+    if (thread->ss_active)
+        return;
+
+    thread->ss_active = true;
+    thread->ss_activation = get_sys_ticks();
+    thread->ss_consumed = 0;
+}
+
+/* Schedule the replenishment of the budget consumed since the activation
+ * once the sporadic server thread blocked or exhausted the budget */
+static void ss_deactivate(struct thread_info *thread)
+{
+    if (!thread->ss_active)
+        return;
+
+    thread->ss_active = false;
+
+    if (thread->ss_consumed == 0)
+        return;
+
+    uint32_t tick = thread->ss_activation + thread->ss_repl_period;
+
+    if (thread->ss_repl_cnt < thread->ss_max_repl) {
+        struct ss_repl *repl = &thread->ss_repl[thread->ss_repl_cnt++];
+        repl->tick = tick;
+        repl->amount = thread->ss_consumed;
+    } else {
+        /* Merge into the last replenishment if no more can be pended */
+        struct ss_repl *repl = &thread->ss_repl[thread->ss_repl_cnt - 1];
+        repl->tick = tick;
+        repl->amount += thread->ss_consumed;
+    }
+
+    thread->ss_consumed = 0;
+}
+
+static inline void ready_list_add(struct thread_info *thread)
+{
+    /* Check if the thread is waking up or just being preempted */
+    if (thread->status != THREAD_READY && thread->status != THREAD_RUNNING) {
+        if (thread->sched_policy == SCHED_DEADLINE)
+            dl_wakeup(thread);
+        else if (thread->sched_policy == SCHED_SPORADIC)
+            ss_replenish(thread, get_sys_ticks());
+    }
+
+    thread->status = THREAD_READY;
+
+    if (thread->priority == DL_PRIORITY) {
+        /* Keep the deadline level sorted by the deadlines */
+        struct list_head *curr;
+        list_for_each (curr, &ready_list[DL_PRIORITY]) {
+            struct thread_info *ready =
+                list_entry(curr, struct thread_info, list);
+            if (dl_before(thread, ready))
+                break;
+        }
+        list_add(&thread->list, curr);
+    } else {
+        list_add(&thread->list, &ready_list[thread->priority]);
+    }
+
+    ready_bitmap |= 1 << thread->priority;
+}
+
+/* Enqueue the thread to the front of its ready list, so a preempted thread
+ * resumes before the other threads with the same priority */
+static inline void ready_list_add_head(struct thread_info *thread)
+{
+    /* The deadline level is always ordered by the deadlines */
+    if (thread->priority == DL_PRIORITY) {
+        ready_list_add(thread);
+        return;
+    }
+
+    thread->status = THREAD_READY;
+    list_add(&thread->list, ready_list[thread->priority].next);
+    ready_bitmap |= 1 << thread->priority;
+}
+
+static inline void ready_list_del(struct thread_info *thread)
+{
+    list_del_init(&thread->list);
+
+    /* Clear the bit if no more thread is ready with the same priority */
+    if (list_empty(&ready_list[thread->priority]))
+        ready_bitmap &= ~(1 << thread->priority);
+}
+
+static inline struct thread_info *ready_list_first(void)
+{
+    /* Find the highest priority that has runnable threads with CLZ */
+    int pri = _flsl(ready_bitmap) - 1;
+
+    return list_first_entry(&ready_list[pri], struct thread_info, list);
+}
+
+/* Preempt the running thread immediately if the woken thread outranks it
+ * instead of waiting for the next tick */
+static void check_preempt_wakeup(struct thread_info *thread)
+{
+    if (thread->priority > running_thread->priority ||
+        (thread->priority == DL_PRIORITY &&
+         running_thread->priority == DL_PRIORITY &&
+         dl_before(thread, running_thread))) {
+        set_need_resched();
+        request_context_switch();
+    }
+}
+
+/* Insert the thread into the wait list sorted by the priority, hence the
+ * first thread is always the one to be woken up next */
+static void wait_list_add(struct thread_info *thread,
+                          struct list_head *wait_list)
+{
+    struct list_head *curr;
+    list_for_each (curr, wait_list) {
+        struct thread_info *waiter = list_entry(curr, struct thread_info, list);
+
+        /* Threads with the same priority are kept in FIFO order */
+        if (waiter->priority < thread->priority)
+            break;
+    }
+
+    /* Insert before the first thread with lower priority */
+    list_add(&thread->list, curr);
+    thread->wait_list = wait_list;
+}
+
+static void wait_list_del(struct thread_info *thread)
+{
+    list_del_init(&thread->list);
+    thread->wait_list = NULL;
+}
+
+/* Remove the thread from the scheduling list it currently belongs to */
+static void thread_dequeue(struct thread_info *thread)
+{
+    if (thread->status == THREAD_READY)
+        ready_list_del(thread);
+    else
+        wait_list_del(thread);
+}
+
+static void thread_set_priority(struct thread_info *thread, uint8_t priority)
+{
+    if (thread->status == THREAD_READY) {
+        /* Move the thread to the ready list with new priority */
+        ready_list_del(thread);
+        thread->priority = priority;
+        ready_list_add(thread);
+    } else if (thread->wait_list) {
+        /* Reorder the thread in the wait list with new priority */
+        struct list_head *wait_list = thread->wait_list;
+        wait_list_del(thread);
+        thread->priority = priority;
+        wait_list_add(thread, wait_list);
+    } else {
+        thread->priority = priority;
+    }
+}
+
+/* Return the highest priority of the threads waiting for the priority
+ * inheritance mutexes and the ceilings of the priority protection mutexes
+ * held by the thread */
+static int pi_waiters_priority(struct thread_info *thread)
+{
+    int priority = -1;
+
+    struct mutex *mtx;
+    list_for_each_entry (mtx, &thread->pi_mutexes, pi_list) {
+        if (mtx->protocol == PTHREAD_PRIO_PROTECT) {
+            if (mtx->prioceiling > priority)
+                priority = mtx->prioceiling;
+            continue;
+        }
+
+        if (list_empty(&mtx->wait_list))
+            continue;
+
+        /* The wait list is sorted by the priority */
+        struct thread_info *waiter =
+            list_first_entry(&mtx->wait_list, struct thread_info, list);
+        if (waiter->priority > priority)
+            priority = waiter->priority;
+    }
+
+    return priority;
+}
+
+/* Recalculate the effective priority of the thread, which is the maximum
+ * of its own priority, the priorities of the threads it is blocking and the
+ * ceilings of the mutexes it holds */
+/* Wake up the throttled thread before its budget is replenished */
+static void thread_unthrottle(struct thread_info *thread)
+{
+    list_del_init(&thread->list);
+    thread->throttled = false;
+    ready_list_add(thread);
+    check_preempt_wakeup(thread);
+}
+
+static void thread_update_priority(struct thread_info *thread)
+{
+    uint8_t base = thread->priority_inherited ? thread->original_priority
+                                              : thread->priority;
+    int waiters = pi_waiters_priority(thread);
+    uint8_t priority = waiters > base ? waiters : base;
+
+    thread->original_priority = base;
+    thread->priority_inherited = waiters > base;
+
+    if (priority == thread->priority)
+        return;
+
+    /* Threads with higher priority may be ready now */
+    if (thread == running_thread && priority < thread->priority)
+        set_need_resched();
+
+    thread_set_priority(thread, priority);
+
+    /* The boosted lock owner must run even if its budget is exhausted,
+     * otherwise the waiters are blocked until the replenishment */
+    if (thread->priority_inherited && thread->throttled)
+        thread_unthrottle(thread);
+}
+
+/* Propagate the priority change of the thread along the chain of the mutex
+ * owners that the threads are blocked on */
+static void pi_chain_update(struct thread_info *thread)
+{
+    /* The chain length is bounded in case of a deadlock cycle */
+    for (int i = 0; thread && i < THREAD_MAX; i++) {
+        uint8_t old_priority = thread->priority;
+        thread_update_priority(thread);
+
+        if (thread->priority == old_priority || !thread->blocked_on)
+            break;
+
+        thread = mutex_owner(thread->blocked_on);
+    }
+}
+
+/* Change the priority of the thread without losing the inherited one */
+static void thread_set_base_priority(struct thread_info *thread,
+                                     uint8_t priority)
+{
+    uint8_t old_priority = thread->priority;
+
+    if (thread->priority_inherited)
+        thread->original_priority = priority;
+    else
+        thread_set_priority(thread, priority);
+
+    thread_update_priority(thread);
+
+    /* Pass the change to the owner of the mutex that the thread waits for */
+    if (thread->priority != old_priority && thread->blocked_on)
+        pi_chain_update(mutex_owner(thread->blocked_on));
+}
+
+/* Convert and validate the SCHED_DEADLINE parameters, then check if the
+ * total bandwidth stays within the limit after replacing the old one */
+static int dl_params_init(struct dl_params *dl,
+                          const struct sched_param *param,
+                          uint32_t old_bw)
+{
+    dl->runtime = timespec_to_ticks(&param->sched_runtime);
+    dl->deadline = timespec_to_ticks(&param->sched_deadline);
+    dl->period = timespec_to_ticks(&param->sched_period);
+
+    /* Implicit deadline */
+    if (dl->deadline == 0)
+        dl->deadline = dl->period;
+
+    if (dl->runtime == 0 || dl->runtime > dl->deadline ||
+        dl->deadline > dl->period)
+        return -EINVAL;
+
+    dl->bw = (uint64_t) dl->runtime * DL_BW_UNIT / dl->period;
+
+    /* Admission control, the deadlines can only be guaranteed if the CPU is
+     * not overloaded */
+    if ((uint64_t) dl_total_bw - old_bw + dl->bw >
+        (uint64_t) DL_BW_UNIT * DL_UTIL_MAX / 100)
+        return -EBUSY;
+
+    return 0;
+}
+
+static void thread_set_deadline(struct thread_info *thread,
+                                struct dl_params *dl)
+{
+    /* Update the bandwidth reservation */
+    if (thread->sched_policy == SCHED_DEADLINE)
+        dl_total_bw -= thread->dl_bw;
+    dl_total_bw += dl->bw;
+
+    thread->sched_policy = SCHED_DEADLINE;
+    thread->dl_runtime = dl->runtime;
+    thread->dl_deadline = dl->deadline;
+    thread->dl_period = dl->period;
+    thread->dl_bw = dl->bw;
+
+    /* Start a new job with the new parameters */
+    thread->dl_abs_deadline = get_sys_ticks() + dl->deadline;
+    thread->dl_budget = dl->runtime;
+    thread->dl_missed = false;
+
+    thread_set_base_priority(thread, DL_PRIORITY);
+}
+
+/* Validate the SCHED_SPORADIC parameters */
+static int ss_params_check(const struct sched_param *param)
+{
+    uint32_t budget = timespec_to_ticks(&param->sched_ss_init_budget);
+    uint32_t period = timespec_to_ticks(&param->sched_ss_repl_period);
+
+    if (budget == 0 || budget > period || param->sched_ss_max_repl < 1 ||
+        param->sched_ss_max_repl > SS_REPL_MAX)
+        return -EINVAL;
+
+    return 0;
+}
+
+static void thread_set_sporadic(struct thread_info *thread,
+                                const struct sched_param *param)
+{
+    thread->sched_policy = SCHED_SPORADIC;
+    thread->ss_init_budget = timespec_to_ticks(&param->sched_ss_init_budget);
+    thread->ss_repl_period = timespec_to_ticks(&param->sched_ss_repl_period);
+    thread->ss_max_repl = param->sched_ss_max_repl;
+
+    /* Start with the full budget */
+    thread->ss_budget = thread->ss_init_budget;
+    thread->ss_repl_cnt = 0;
+    thread->ss_active = thread == running_thread;
+    thread->ss_activation = get_sys_ticks();
+    thread->ss_consumed = 0;
+}
+
+static void thread_clear_deadline(struct thread_info *thread)
+{
+    if (thread->sched_policy != SCHED_DEADLINE)
+        return;
+
+    /* Release the bandwidth reservation */
+    dl_total_bw -= thread->dl_bw;
+    thread->dl_bw = 0;
+    thread->sched_policy = SCHED_RR;
+}
+
+/* Insert the thread into the timeout list sorted by the deadline tick */
+static void timeout_list_add(struct thread_info *thread)
+{
+    struct list_head *curr;
+    list_for_each (curr, &timeout_list) {
+        struct thread_info *waiter =
+            list_entry(curr, struct thread_info, timeout_list);
+
+        /* Threads with the same deadline are kept in FIFO order */
+        if (time_after(waiter->timeout_tick, thread->timeout_tick))
+            break;
+    }
+
+    /* Insert before the first thread with later deadline */
+    list_add(&thread->timeout_list, curr);
+}
+
+/* Insert the thread into the sleep list sorted by the wake-up tick */
+static void sleep_list_add(struct thread_info *thread)
+{
+    struct list_head *curr;
+    list_for_each (curr, &sleep_list) {
+        struct thread_info *sleeper =
+            list_entry(curr, struct thread_info, list);
+
+        /* Threads with the same wake-up tick are kept in FIFO order */
+        if (time_after(sleeper->wakeup_tick, thread->wakeup_tick))
+            break;
+    }
+
+    /* Insert before the first thread that wakes up later */
+    list_add(&thread->list, curr);
+}
+
+/* Insert the thread into the hrtimer sleep list sorted by the wake-up time */
+static void hrsleep_list_add(struct thread_info *thread)
+{
+    struct list_head *curr;
+    list_for_each (curr, &hrsleep_list) {
+        struct thread_info *sleeper =
+            list_entry(curr, struct thread_info, list);
+
+        /* Threads with the same wake-up time are kept in FIFO order */
+        if (sleeper->wakeup_ns > thread->wakeup_ns)
+            break;
+    }
+
+    /* Insert before the first thread that wakes up later */
+    list_add(&thread->list, curr);
+}
+
+static void hrtimer_program(ktime_t ns)
+{
+    /* Round up to the microsecond resolution of the hrtimer, the timer
+     * will simply be reprogrammed if the time exceeds its range */
+    ktime_t usec = (ns + 999) / 1000;
+    __hrtimer_start(usec > UINT32_MAX ? UINT32_MAX : usec);
+}
+
 /* Consume the stack memory from the thread and create an unique
  * anonymous pipe for it
  */
@@ -359,7 +941,9 @@ static int thread_create(struct thread_info **new_thread,
 
     /* Check if the thread priority is invalid */
     bool bad_priority;
-    if (kernel_thread) {
+    if (attr->schedpolicy == SCHED_DEADLINE) {
+        bad_priority = false; /* Not used */
+    } else if (kernel_thread) {
         bad_priority = attr->schedparam.sched_priority < 0 ||
                        attr->schedparam.sched_priority > KTHREAD_PRI_MAX;
     } else {
@@ -368,11 +952,27 @@ static int thread_create(struct thread_info **new_thread,
     }
 
     /* Check if the scheduling policy is invalid */
-    bool bad_sched_policy = attr->schedpolicy != SCHED_RR;
+    bool bad_sched_policy = attr->schedpolicy != SCHED_RR &&
+                            attr->schedpolicy != SCHED_FIFO &&
+                            attr->schedpolicy != SCHED_SPORADIC &&
+                            attr->schedpolicy != SCHED_DEADLINE;
 
     if (bad_detach_state || bad_priority || bad_sched_policy)
         return -EINVAL;
 
+    /* Check the parameters of the sporadic server thread */
+    if (attr->schedpolicy == SCHED_SPORADIC &&
+        ss_params_check(&attr->schedparam) < 0)
+        return -EINVAL;
+
+    /* Check the parameters and the bandwidth of the deadline thread */
+    struct dl_params dl;
+    if (attr->schedpolicy == SCHED_DEADLINE) {
+        int retval = dl_params_init(&dl, &attr->schedparam, 0);
+        if (retval < 0)
+            return retval;
+    }
+
     /* Allocate new thread Id */
     int tid = find_first_zero_bit(bitmap_threads, THREAD_MAX);
     if (tid >= THREAD_MAX)
@@ -385,8 +985,14 @@ static int thread_create(struct thread_info **new_thread,
     /* Allocate new thread control block */
     struct thread_info *thread = &threads[tid];
 
-    /* Reset thread data */
+    /* Reset thread data but advance the generation counter so the IDs of the
+     * previous threads using the same control block become invalid */
+    uint16_t gen = thread->gen + 1;
     memset(thread, 0, sizeof(struct thread_info));
+    thread->gen = gen;
+
+    /* Initialize the list of held priority inheritance mutexes */
+    INIT_LIST_HEAD(&thread->pi_mutexes);
 
     /* Allocate thread stack memory */
     thread->stack = alloc_pages(size_to_page_order(stack_size));
@@ -413,9 +1019,10 @@ static int thread_create(struct thread_info **new_thread,
 
     /* Initialize thread parameters */
     thread->stack_size = stack_size; /* Bytes */
-    thread->status = THREAD_WAIT;
     thread->tid = tid;
     thread->priority = attr->schedparam.sched_priority;
+    thread->sched_policy = attr->schedpolicy;
+    thread->time_slice = SCHED_RR_TIMESLICE;
     thread->kernel_thread = kernel_thread;
     thread->privilege = kernel_thread ? KERNEL_THREAD : USER_THREAD;
 
@@ -427,17 +1034,25 @@ static int thread_create(struct thread_info **new_thread,
         thread->detached = false;
     }
 
+    if (attr->schedpolicy == SCHED_DEADLINE)
+        thread_set_deadline(thread, &dl);
+    else if (attr->schedpolicy == SCHED_SPORADIC)
+        thread_set_sporadic(thread, &attr->schedparam);
+
     /* Initialize poll file list */
     INIT_LIST_HEAD(&thread->poll_files_list);
 
     /* Initialize the thread join list */
     INIT_LIST_HEAD(&thread->join_list);
 
+    /* Initialize the timeout list node so it can be removed unconditionally */
+    INIT_LIST_HEAD(&thread->timeout_list);
+
     /* Link the thread to the global thread list */
     list_add(&thread->thread_list, &threads_list);
 
-    /* Enqueue the thread into the sleep list */
-    list_add(&thread->list, &sleep_list);
+    /* Enqueue the thread into the ready list */
+    ready_list_add(thread);
 
     /* Return the pointer of the thread */
     *new_thread = thread;
@@ -531,6 +1146,10 @@ static void enqueue_pending_signal(struct thread_info *thread,
     if (thread->signal_cnt >= SIGNAL_QUEUE_SIZE)
         printk("Warning: the oldest pending signal is overwritten");
 
+    /* Reschedule so the signal handler of the running thread is staged */
+    if (thread == running_thread)
+        set_need_resched();
+
     /* Push new signal into the pending queue */
     struct staged_handler_info info;
     info.func = func;
@@ -577,23 +1196,35 @@ static void thread_resume(struct thread_info *thread)
     if (thread->status != THREAD_SUSPENDED)
         return;
 
-    thread->status = THREAD_READY;
-    list_move(&thread->list, &ready_list[thread->priority]);
+    wait_list_del(thread);
+    ready_list_add(thread);
 }
 
-static void thread_delete(struct thread_info *thread)
+/* Remove the thread from the system and release its resources. Shared by
+ * all the paths that terminate a thread */
+static void thread_release(struct thread_info *thread)
 {
-    /* Remove the thread from the system */
     list_del(&thread->task_list);
     list_del(&thread->thread_list);
     if (thread != running_thread)
-        list_del(&thread->list);
+        thread_dequeue(thread);
+    list_del_init(&thread->timeout_list);
+
+    /* Return the bandwidth reserved by the deadline thread */
+    thread_clear_deadline(thread);
+
     thread->status = THREAD_TERMINATED;
     bitmap_clear_bit(bitmap_threads, thread->tid);
 
     /* Free the thread stack memory */
     free_pages((uint32_t) thread->stack,
                size_to_page_order(thread->stack_size));
+}
+
+static void thread_delete(struct thread_info *thread)
+{
+    /* Remove the thread from the system */
+    thread_release(thread);
 
     /* Remove the task from the system if it contains no more thread */
     struct task_struct *task = current_task_info();
@@ -607,19 +1238,52 @@ void prepare_to_wait(struct list_head *wait_list,
 {
     preempt_disable();
 
-    list_add(&thread->list, wait_list);
+    thread_dequeue(thread);
+    wait_list_add(thread, wait_list);
     thread->status = state;
 
     preempt_enable();
 }
 
+void prepare_to_wait_timeout(struct list_head *wait_list,
+                             struct thread_info *thread,
+                             int state,
+                             uint32_t ticks)
+{
+    preempt_disable();
+
+    prepare_to_wait(wait_list, thread, state);
+
+    /* Add the thread into the timeout monitoring list */
+    thread->timeout_tick = get_sys_ticks() + ticks;
+    thread->syscall_is_timeout = false;
+    timeout_list_add(thread);
+
+    preempt_enable();
+}
+
+bool finish_wait_timeout(struct thread_info *thread)
+{
+    preempt_disable();
+
+    /* Remove the thread from the timeout monitoring list if it is woken up
+     * before the deadline */
+    list_del_init(&thread->timeout_list);
+    bool timeout = thread->syscall_is_timeout;
+
+    preempt_enable();
+
+    return timeout;
+}
+
 void finish_wait(struct thread_info *thread)
 {
     preempt_disable();
 
     if (thread != running_thread) {
-        thread->status = THREAD_READY;
-        list_move(&thread->list, &ready_list[thread->priority]);
+        thread_dequeue(thread);
+        ready_list_add(thread);
+        check_preempt_wakeup(thread);
     }
 
     preempt_enable();
@@ -632,20 +1296,15 @@ void wake_up(struct list_head *wait_list)
     if (list_empty(wait_list))
         goto leave;
 
+    /* The waiting list is sorted by the priority, so the first thread is the
+     * first highest-priority thread */
     struct thread_info *highest_pri_thread =
         list_first_entry(wait_list, struct thread_info, list);
 
-    /* Find the first highest-priority thread in the waiting list */
-    struct thread_info *thread;
-    list_for_each_entry (thread, wait_list, list) {
-        if (thread->priority > highest_pri_thread->priority)
-            highest_pri_thread = thread;
-    }
-
     /* Wake up the first highest-priority thread in the waiting list */
-    list_move(&highest_pri_thread->list,
-              &ready_list[highest_pri_thread->priority]);
-    highest_pri_thread->status = THREAD_READY;
+    wait_list_del(highest_pri_thread);
+    ready_list_add(highest_pri_thread);
+    check_preempt_wakeup(highest_pri_thread);
 
 leave:
     preempt_enable();
@@ -660,8 +1319,9 @@ void wake_up_all(struct list_head *wait_list)
     list_for_each_safe (curr, next, wait_list) {
         struct thread_info *thread = list_entry(curr, struct thread_info, list);
 
-        list_move(&thread->list, &ready_list[thread->priority]);
-        thread->status = THREAD_READY;
+        wait_list_del(thread);
+        ready_list_add(thread);
+        check_preempt_wakeup(thread);
     }
 
     preempt_enable();
@@ -690,14 +1350,7 @@ static inline void thread_join_handler(void)
     }
 
     /* Remove the thread from the system */
-    list_del(&running_thread->thread_list);
-    list_del(&running_thread->task_list);
-    running_thread->status = THREAD_TERMINATED;
-    bitmap_clear_bit(bitmap_threads, running_thread->tid);
-
-    /* Free the thread stack memory */
-    free_pages((uint32_t) running_thread->stack,
-               size_to_page_order(running_thread->stack_size));
+    thread_release(running_thread);
 }
 
 static struct thread_info *thread_info_find_next(struct thread_info *curr)
@@ -755,6 +1408,12 @@ static void *sys_thread_info(struct thread_stat *info, void *next)
     info->pid = thread->task->pid;
     info->tid = thread->tid;
     info->priority = thread->priority;
+    info->policy = thread->sched_policy;
+    info->dl_misses = thread->dl_misses;
+    info->throttle_cnt = thread->throttle_cnt;
+    info->cpu_time = thread_cputime_ns(thread);
+    info->nvcsw = thread->nvcsw;
+    info->nivcsw = thread->nivcsw;
     info->kernel_thread = thread->kernel_thread;
     info->stack_usage =
         (size_t) ((uintptr_t) thread->stack + thread->stack_size -
@@ -792,16 +1451,35 @@ static void sys_setprogname(const char *name)
     running_thread->name[THREAD_NAME_MAX - 1] = '\0';
 }
 
+static int sys_thread_cputime(struct timespec *tp)
+{
+    preempt_disable();
+
+    uint64_t ns = thread_cputime_ns(running_thread);
+    tp->tv_sec = ns / 1000000000;
+    tp->tv_nsec = ns % 1000000000;
+
+    preempt_enable();
+
+    return 0;
+}
+
 static int sys_delay_ticks(uint32_t ticks)
 {
     preempt_disable();
 
-    /* Reconfigure the tick to sleep */
-    running_thread->sleep_ticks = ticks;
+    if (ticks == 0) {
+        /* Nothing to wait, simply yield the CPU */
+        ready_list_add(running_thread);
+        set_need_resched();
+    } else {
+        /* Set the absolute tick to wake up */
+        running_thread->wakeup_tick = get_sys_ticks() + ticks;
 
-    /* Enqueue the thread into the sleep list */
-    running_thread->status = THREAD_WAIT;
-    list_add(&(running_thread->list), &sleep_list);
+        /* Enqueue the thread into the sleep list */
+        running_thread->status = THREAD_WAIT;
+        sleep_list_add(running_thread);
+    }
 
     preempt_enable();
 
@@ -873,8 +1551,13 @@ static int sys_minfo(int name)
 
 static int sys_sched_yield(void)
 {
-    /* Suspend current thread */
-    prepare_to_wait(&sleep_list, running_thread, THREAD_WAIT);
+    preempt_disable();
+
+    /* Move current thread to the tail of the ready list */
+    ready_list_add(running_thread);
+    set_need_resched();
+
+    preempt_enable();
 
     /* Return success */
     return 0;
@@ -897,15 +1580,7 @@ static void sys_exit(int status)
             list_entry(curr, struct thread_info, task_list);
 
         /* Remove current thread of iteration from the system */
-        list_del(&thread->thread_list);
-        list_del(&thread->task_list);
-        list_del(&thread->list);
-        thread->status = THREAD_TERMINATED;
-        bitmap_clear_bit(bitmap_threads, thread->tid);
-
-        /* Free the stack memory */
-        free_pages((uint32_t) thread->stack,
-                   size_to_page_order(thread->stack_size));
+        thread_release(thread);
     }
 
     /* Remove the task from the system */
@@ -1502,6 +2177,27 @@ static int sys_getpid(void)
     return current_task_info()->pid;
 }
 
+static int sys_sysinfo(struct sysinfo *info)
+{
+    preempt_disable();
+
+    info->uptime = get_sys_ticks() / OS_TICK_FREQ;
+    info->cpu_freq = __cpu_freq();
+
+    for (int i = 0; i < 3; i++)
+        info->loads[i] = loadavg[i];
+
+    info->procs = 0;
+    for (int i = 0; i < THREAD_MAX; i++) {
+        if (bitmap_get_bit(bitmap_threads, i))
+            info->procs++;
+    }
+
+    preempt_enable();
+
+    return 0;
+}
+
 static int sys_mknod(const char *pathname, mode_t mode, dev_t dev)
 {
     /* Check the length of the pathname */
@@ -1592,11 +2288,13 @@ static int sys_poll(struct pollfd *fds, nfds_t nfds, int timeout)
 
     /* Set polling deadline */
     if (timeout > 0) {
-        struct timespec tp;
-        get_sys_time(&tp);
-        time_add(&tp, 0, timeout * 1000000);
-        running_thread->syscall_timeout = tp;
+        struct timespec tp = {
+            .tv_sec = timeout / 1000,
+            .tv_nsec = (timeout % 1000) * 1000000,
+        };
+        running_thread->timeout_tick = get_sys_ticks() + timespec_to_ticks(&tp);
     }
+    running_thread->syscall_is_timeout = false;
 
     /* Initialize the polling file list */
     INIT_LIST_HEAD(&running_thread->poll_files_list);
@@ -1636,7 +2334,7 @@ static int sys_poll(struct pollfd *fds, nfds_t nfds, int timeout)
 
     /* Add current thread into the timeout monitoring list */
     if (timeout > 0)
-        list_add(&running_thread->timeout_list, &timeout_list);
+        timeout_list_add(running_thread);
 
     /* Record all files for polling */
     for (int i = 0; i < nfds; i++) {
@@ -1651,9 +2349,10 @@ static int sys_poll(struct pollfd *fds, nfds_t nfds, int timeout)
     /* clear list of poll files */
     INIT_LIST_HEAD(&running_thread->poll_files_list);
 
-    /* Remove the thread from the polling list */
+    /* Remove the thread from the timeout monitoring list if it is woken up
+     * before the deadline */
     if (timeout > 0)
-        list_del(&running_thread->timeout_list);
+        list_del_init(&running_thread->timeout_list);
 
     /* TODO: Specify the failed reason */
     retval = (running_thread->syscall_is_timeout) ? -1 : 0;
@@ -1995,8 +2694,14 @@ static int sys_pthread_create(pthread_t *pthread,
     struct thread_attr default_attr;
     if (attr == NULL) {
         pthread_attr_init((pthread_attr_t *) &default_attr);
-        default_attr.schedparam.sched_priority = running_thread->priority;
         attr = &default_attr;
+
+        /* The bandwidth of the deadline thread is not inherited, the new
+         * thread uses the highest user priority instead */
+        if (running_thread->sched_policy == SCHED_DEADLINE)
+            default_attr.schedparam.sched_priority = THREAD_PRIORITY_MAX;
+        else
+            default_attr.schedparam.sched_priority = running_thread->priority;
     }
 
     /* Create new thread */
@@ -2013,7 +2718,7 @@ static int sys_pthread_create(pthread_t *pthread,
         list_add(&thread->task_list, &current_task_info()->threads_list);
 
         /* Return thread ID */
-        *pthread = thread->tid;
+        *pthread = thread_id(thread);
     }
 
     preempt_enable();
@@ -2023,7 +2728,7 @@ static int sys_pthread_create(pthread_t *pthread,
 
 static pthread_t sys_pthread_self(void)
 {
-    return running_thread->tid;
+    return thread_id(running_thread);
 }
 
 static int sys_pthread_join(pthread_t tid, void **pthread_retval)
@@ -2105,14 +2810,17 @@ static int sys_pthread_detach(pthread_t tid)
 
     int retval;
 
+    /* Acquire the thread with given ID */
+    struct thread_info *thread = acquire_thread(tid);
+
     /* Check if the thread exists */
-    if (!bitmap_get_bit(bitmap_threads, tid)) {
+    if (!thread) {
         /* Return error */
         retval = -ESRCH;
         goto leave;
     }
 
-    threads[tid].detached = true;
+    thread->detached = true;
 
     /* Return success */
     retval = 0;
@@ -2144,6 +2852,29 @@ static int sys_pthread_setschedparam(pthread_t tid,
         goto leave;
     }
 
+    /* Unsupported scheduling policy */
+    if (policy != SCHED_FIFO && policy != SCHED_RR &&
+        policy != SCHED_SPORADIC && policy != SCHED_DEADLINE) {
+        /* Return error */
+        retval = -EINVAL;
+        goto leave;
+    }
+
+    if (policy == SCHED_DEADLINE) {
+        /* Check the parameters and the bandwidth */
+        struct dl_params dl;
+        retval = dl_params_init(&dl, param, thread->dl_bw);
+        if (retval < 0)
+            goto leave;
+
+        /* Apply settings */
+        thread_set_deadline(thread, &dl);
+
+        /* Return success */
+        retval = 0;
+        goto leave;
+    }
+
     /* Invalid priority parameter */
     if (param->sched_priority < 0 ||
         param->sched_priority > THREAD_PRIORITY_MAX) {
@@ -2152,11 +2883,21 @@ static int sys_pthread_setschedparam(pthread_t tid,
         goto leave;
     }
 
+    /* Invalid sporadic server parameters */
+    if (policy == SCHED_SPORADIC && ss_params_check(param) < 0) {
+        /* Return error */
+        retval = -EINVAL;
+        goto leave;
+    }
+
     /* Apply settings */
-    if (thread->priority_inherited)
-        thread->original_priority = param->sched_priority;
+    thread_clear_deadline(thread);
+    if (policy == SCHED_SPORADIC)
+        thread_set_sporadic(thread, param);
     else
-        thread->priority = param->sched_priority;
+        thread->sched_policy = policy;
+
+    thread_set_base_priority(thread, param->sched_priority);
 
     /* Return success */
     retval = 0;
@@ -2189,11 +2930,24 @@ static int sys_pthread_getschedparam(pthread_t tid,
     }
 
     /* Return settings */
+    *policy = thread->sched_policy;
     if (thread->priority_inherited)
         param->sched_priority = thread->original_priority;
     else
         param->sched_priority = thread->priority;
 
+    if (thread->sched_policy == SCHED_SPORADIC) {
+        ticks_to_timespec(thread->ss_init_budget,
+                          &param->sched_ss_init_budget);
+        ticks_to_timespec(thread->ss_repl_period,
+                          &param->sched_ss_repl_period);
+        param->sched_ss_max_repl = thread->ss_max_repl;
+    } else if (thread->sched_policy == SCHED_DEADLINE) {
+        ticks_to_timespec(thread->dl_runtime, &param->sched_runtime);
+        ticks_to_timespec(thread->dl_deadline, &param->sched_deadline);
+        ticks_to_timespec(thread->dl_period, &param->sched_period);
+    }
+
     /* Return success */
     retval = 0;
 
@@ -2204,8 +2958,13 @@ leave:
 
 static int sys_pthread_yield(void)
 {
+    preempt_disable();
+
     /* Yield the time quatum to other threads */
-    prepare_to_wait(&sleep_list, running_thread, THREAD_WAIT);
+    ready_list_add(running_thread);
+    set_need_resched();
+
+    preempt_enable();
 
     /* Return success */
     return 0;
@@ -2335,34 +3094,28 @@ void thread_inherit_priority(struct mutex *mutex)
 
     preempt_disable();
 
-    struct thread_info *onwer_thread = mutex->owner;
+    struct thread_info *owner_thread = mutex_owner(mutex);
 
-    /* Preserve original priority */
-    if (!onwer_thread->priority_inherited) {
-        running_thread->original_priority = running_thread->priority;
-        onwer_thread->priority_inherited = true;
-    }
+    /* Track the mutex with the owner as it may be acquired with the fast
+     * path, which is invisible to the kernel */
+    if (list_empty(&mutex->pi_list))
+        list_add(&mutex->pi_list, &owner_thread->pi_mutexes);
 
-    /* Priority Inheritance Protocol (PIP) */
-    if (running_thread->priority > onwer_thread->priority) {
-        /* Raise the priority of the owner thread */
-        uint8_t old_priority = onwer_thread->priority;
-        uint8_t new_priority = running_thread->priority;
+    /* Priority Inheritance Protocol (PIP), the raised priority is also
+     * passed to the owners of the mutexes that the owner is blocked on */
+    pi_chain_update(owner_thread);
 
-        /* Move the owner thread from the ready list with lower priority to
-         * the new list with raised priority  */
-        struct list_head *curr, *next;
-        list_for_each_safe (curr, next, &ready_list[old_priority]) {
-            struct thread_info *thread =
-                list_entry(curr, struct thread_info, list);
-            if (thread == mutex->owner) {
-                list_move(&thread->list, &ready_list[new_priority]);
-            }
-        }
+    preempt_enable();
+}
 
-        /* Set new raised priority */
-        onwer_thread->priority = new_priority;
-    }
+void thread_raise_ceiling(struct mutex *mutex)
+{
+    preempt_disable();
+
+    /* Immediate Priority Ceiling Protocol (IPCP), the owner runs at the
+     * ceiling priority until the mutex is released */
+    list_add(&mutex->pi_list, &running_thread->pi_mutexes);
+    thread_update_priority(running_thread);
 
     preempt_enable();
 }
@@ -2371,11 +3124,12 @@ void thread_reset_inherited_priority(struct mutex *mutex)
 {
     preempt_disable();
 
-    if (running_thread->priority_inherited) {
-        /* Recover the original thread priority */
-        running_thread->priority = running_thread->original_priority;
-        running_thread->priority_inherited = false;
-    }
+    /* The mutex no longer contributes to the priority of the thread */
+    list_del_init(&mutex->pi_list);
+
+    /* Recover the priority inherited from the other held mutexes only */
+    if (running_thread->priority_inherited)
+        thread_update_priority(running_thread);
 
     preempt_enable();
 }
@@ -2417,10 +3171,11 @@ static int sys_pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex)
 {
     preempt_disable();
 
-    if (((struct mutex *) mutex)->owner) {
-        /* Release the mutex */
-        ((struct mutex *) mutex)->owner = NULL;
+    /* Release the mutex and wake up the threads waiting for it. The mutex
+     * will be locked again by the caller after being signaled */
+    int retval = mutex_unlock((struct mutex *) mutex);
 
+    if (retval == 0) {
         /* Enqueue current thread into the read waiting list */
         prepare_to_wait(&((struct cond *) cond)->task_wait_list, running_thread,
                         THREAD_WAIT);
@@ -2428,8 +3183,7 @@ static int sys_pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex)
 
     preempt_enable();
 
-    /* Return success */
-    return 0;
+    return retval;
 }
 
 static int sys_pthread_once(pthread_once_t *_once_control,
@@ -2461,6 +3215,56 @@ leave:
     return 0;
 }
 
+static int sys_pthread_rwlock_rdlock(pthread_rwlock_t *rwlock)
+{
+    return rwlock_rdlock((struct rwlock *) rwlock);
+}
+
+static int sys_pthread_rwlock_tryrdlock(pthread_rwlock_t *rwlock)
+{
+    return rwlock_tryrdlock((struct rwlock *) rwlock);
+}
+
+static int sys_pthread_rwlock_wrlock(pthread_rwlock_t *rwlock)
+{
+    return rwlock_wrlock((struct rwlock *) rwlock);
+}
+
+static int sys_pthread_rwlock_trywrlock(pthread_rwlock_t *rwlock)
+{
+    return rwlock_trywrlock((struct rwlock *) rwlock);
+}
+
+static int sys_pthread_rwlock_unlock(pthread_rwlock_t *rwlock)
+{
+    return rwlock_unlock((struct rwlock *) rwlock);
+}
+
+static int sys_event_set(event_t *event, uint32_t bits)
+{
+    event_group_set((struct event_group *) event, bits);
+
+    /* Return success */
+    return 0;
+}
+
+static int sys_event_clear(event_t *event, uint32_t bits)
+{
+    event_group_clear((struct event_group *) event, bits);
+
+    /* Return success */
+    return 0;
+}
+
+static int sys_event_wait(event_t *event,
+                          uint32_t *bits,
+                          int options,
+                          const struct timespec *timeout)
+{
+    return event_group_wait((struct event_group *) event, bits, options,
+                            timeout);
+}
+
 static int sys_sem_post(sem_t *sem)
 {
     return up((struct semaphore *) sem);
@@ -2645,19 +3449,52 @@ leave:
     return retval;
 }
 
-static int sys_clock_gettime(clockid_t clockid, struct timespec *tp)
+static int sys_clock_nanosleep(clockid_t clockid,
+                               int flags,
+                               const struct timespec *req,
+                               struct timespec *rem)
 {
     preempt_disable();
 
     int retval;
 
-    if (clockid != CLOCK_MONOTONIC) {
+    if (clockid != CLOCK_MONOTONIC || req->tv_sec < 0 || req->tv_nsec < 0 ||
+        req->tv_nsec >= 1000000000) {
         /* Return error */
         retval = -EINVAL;
         goto leave;
     }
 
-    get_sys_time(tp);
+    /* The sleep can not be interrupted by signals */
+    if (rem && !(flags & TIMER_ABSTIME)) {
+        rem->tv_sec = 0;
+        rem->tv_nsec = 0;
+    }
+
+    ktime_t now = ktime_get_ns();
+    ktime_t ns = (ktime_t) req->tv_sec * 1000000000 + req->tv_nsec;
+
+    /* Convert the absolute time into the interval to sleep */
+    if (flags & TIMER_ABSTIME)
+        ns -= now;
+
+    if (ns <= 0) {
+        /* Nothing to wait, simply yield the CPU */
+        ready_list_add(running_thread);
+        set_need_resched();
+    } else {
+        /* Set the absolute time to wake up */
+        running_thread->wakeup_ns = now + ns;
+
+        /* Enqueue the thread into the hrtimer sleep list */
+        running_thread->status = THREAD_WAIT;
+        hrsleep_list_add(running_thread);
+
+        /* Rearm the hrtimer if the thread is the first one to wake up */
+        if (list_first_entry(&hrsleep_list, struct thread_info, list) ==
+            running_thread)
+            hrtimer_program(ns);
+    }
 
     /* Return success */
     retval = 0;
@@ -2673,13 +3510,16 @@ static int sys_clock_settime(clockid_t clockid, const struct timespec *tp)
 
     int retval;
 
-    if (clockid != CLOCK_MONOTONIC) {
+    /* CLOCK_MONOTONIC can't be set, otherwise the sleeping threads and the
+     * timers would expire too late or too early */
+    if (clockid != CLOCK_REALTIME || tp->tv_sec < 0 || tp->tv_nsec < 0 ||
+        tp->tv_nsec >= 1000000000) {
         /* Return error */
         retval = -EINVAL;
         goto leave;
     }
 
-    set_sys_time(tp);
+    set_sys_realtime(tp);
 
     /* Return success */
     retval = 0;
@@ -2702,6 +3542,27 @@ static struct timer *acquire_timer(int timerid)
     return NULL; /* Not found */
 }
 
+/* Link the timer to the wheel bucket of its expiration tick */
+static void timer_wheel_add(struct timer *timer)
+{
+    list_add(&timer->g_list,
+             &timer_wheel[timer->expire_tick % TIMER_WHEEL_SIZE]);
+}
+
+/* Read the remaining time of the timer */
+static void timer_get_remain(struct timer *timer, struct itimerspec *value)
+{
+    value->it_interval = timer->setting.it_interval;
+
+    if (timer->enabled) {
+        ticks_to_timespec(timer->expire_tick - get_sys_ticks(),
+                          &value->it_value);
+    } else {
+        value->it_value.tv_sec = 0;
+        value->it_value.tv_nsec = 0;
+    }
+}
+
 static int sys_timer_create(clockid_t clockid,
                             struct sigevent *sevp,
                             timer_t *timerid)
@@ -2738,13 +3599,15 @@ static int sys_timer_create(clockid_t clockid,
     new_tm->id = running_thread->timer_cnt;
     new_tm->sev = *sevp;
     new_tm->thread = running_thread;
+    new_tm->enabled = false;
+    INIT_LIST_HEAD(&new_tm->g_list);
 
     /* Initialize thread timer list */
     if (running_thread->timer_cnt == 0)
         INIT_LIST_HEAD(&running_thread->timers_list);
 
-    /* Link the new timer to the list */
-    list_add(&new_tm->g_list, &timers_list);
+    /* Link the new timer to the thread timer list, it will be linked to the
+     * timer wheel once armed */
     list_add(&new_tm->list, &running_thread->timers_list);
 
     /* Return timer ID */
@@ -2778,7 +3641,7 @@ static int sys_timer_delete(timer_t timerid)
     }
 
     /* Remove the timer from the lists and free the memory */
-    list_del(&timer->g_list);
+    list_del(&timer->g_list); /* Self-linked if the timer is disarmed */
     list_del(&timer->list);
     kfree(timer);
 
@@ -2826,16 +3689,24 @@ static int sys_timer_settime(timer_t timerid,
 
     /* Return old setting of the timer */
     if (old_value != NULL)
-        *old_value = timer->setting;
+        timer_get_remain(timer, old_value);
+
+    /* Disarm the timer and unlink it from the timer wheel */
+    list_del_init(&timer->g_list);
+    timer->enabled = false;
 
     /* Save new setting of the timer */
     timer->flags = flags;
     timer->setting = *new_value;
-    timer->ret_time = timer->setting;
 
-    /* Enable the timer */
-    timer->counter = timer->setting.it_value;
-    timer->enabled = true;
+    /* Arm the timer only if the initial expiration is non-zero */
+    uint32_t value_ticks = timespec_to_ticks(&new_value->it_value);
+    if (value_ticks > 0) {
+        timer->expire_tick = get_sys_ticks() + value_ticks;
+        timer->interval_ticks = timespec_to_ticks(&new_value->it_interval);
+        timer->enabled = true;
+        timer_wheel_add(timer);
+    }
 
     /* Return success */
     retval = 0;
@@ -2861,7 +3732,7 @@ static int sys_timer_gettime(timer_t timerid, struct itimerspec *curr_value)
         goto leave;
     }
 
-    *curr_value = timer->ret_time;
+    timer_get_remain(timer, curr_value);
 
     /* Return success */
     retval = 0;
@@ -2902,39 +3773,49 @@ static void sys_free(void *ptr)
 
 static void threads_ticks_update(void)
 {
-    /* Update sleep ticks */
-    struct thread_info *thread;
-    list_for_each_entry (thread, &sleep_list, list) {
-        /* Update remained ticks for sleeping */
-        if (thread->sleep_ticks > 0)
-            thread->sleep_ticks--;
+    uint32_t now = get_sys_ticks();
+
+    /* The sleep list is sorted by the wake-up tick, hence only the threads
+     * at the front of the list need to be checked */
+    while (!list_empty(&sleep_list)) {
+        struct thread_info *thread =
+            list_first_entry(&sleep_list, struct thread_info, list);
+
+        /* Stop at the first thread that still needs to sleep */
+        if (!time_after_eq(now, thread->wakeup_tick))
+            break;
+
+        /* Enqueue the thread into the ready list */
+        list_del_init(&thread->list);
+        thread->throttled = false;
+        ready_list_add(thread);
+        check_preempt_wakeup(thread);
     }
 }
 
 static void timers_update(void)
 {
-    struct timer *timer;
-    list_for_each_entry (timer, &timers_list, g_list) {
-        if (!timer->enabled)
-            continue;
+    uint32_t now = get_sys_ticks();
 
-        /* Update the timer */
-        timer_down_count(&timer->counter);
+    /* Only the timers hashed into the bucket of current tick can expire */
+    struct list_head *bucket = &timer_wheel[now % TIMER_WHEEL_SIZE];
 
-        /* Update the return time */
-        timer->ret_time.it_value = timer->counter;
+    struct list_head *curr, *next;
+    list_for_each_safe (curr, next, bucket) {
+        struct timer *timer = list_entry(curr, struct timer, g_list);
 
-        /* Check if the time is up */
-        if (timer->counter.tv_sec != 0 || timer->counter.tv_nsec != 0) {
+        /* Check if the time is up or the timer is for later rounds */
+        if (!time_after_eq(now, timer->expire_tick))
             continue; /* No */
-        }
-
-        /* Reload the timer */
-        timer->counter = timer->setting.it_interval;
 
-        /* Shutdown the one-shot type timer */
-        if (timer->setting.it_interval.tv_sec == 0 &&
-            timer->setting.it_interval.tv_nsec == 0) {
+        if (timer->interval_ticks > 0) {
+            /* Reload the timer */
+            timer->expire_tick += timer->interval_ticks;
+            list_del(curr);
+            timer_wheel_add(timer);
+        } else {
+            /* Shutdown the one-shot type timer */
+            list_del_init(curr);
             timer->enabled = false;
         }
 
@@ -2950,35 +3831,107 @@ static void timers_update(void)
 
 static void syscall_timeout_update(void)
 {
-    /* Get current time */
-    struct timespec tp;
-    get_sys_time(&tp);
+    uint32_t now = get_sys_ticks();
 
-    /* Iterate through all threads that waiting for poll events */
-    struct thread_info *thread;
-    list_for_each_entry (thread, &timeout_list, timeout_list) {
-        /* Wake up the thread if the time is up */
-        if (tp.tv_sec >= thread->syscall_timeout.tv_sec &&
-            tp.tv_nsec >= thread->syscall_timeout.tv_nsec) {
-            thread->syscall_is_timeout = true;
-            finish_wait(thread);
-        }
+    /* The timeout list is sorted by the deadline, hence only the threads at
+     * the front of the list need to be checked */
+    while (!list_empty(&timeout_list)) {
+        struct thread_info *thread =
+            list_first_entry(&timeout_list, struct thread_info, timeout_list);
+
+        /* Stop at the first thread that is not timed out yet */
+        if (!time_after_eq(now, thread->timeout_tick))
+            break;
+
+        /* Wake up the thread as the time is up */
+        list_del_init(&thread->timeout_list);
+        thread->syscall_is_timeout = true;
+        finish_wait(thread);
     }
 }
 
-static inline void set_need_resched(void)
+/* Count the deadline miss once if the job is still unfinished after its
+ * deadline */
+static void dl_check_miss(struct thread_info *thread, uint32_t now)
 {
-    need_resched_flag = true;
+    if (!thread->dl_missed && time_after(now, thread->dl_abs_deadline)) {
+        thread->dl_missed = true;
+        thread->dl_misses++;
+    }
 }
 
-static inline void reset_need_resched(void)
+static void deadline_update(void)
 {
-    need_resched_flag = false;
+    uint32_t now = get_sys_ticks();
+
+    struct thread_info *thread;
+    list_for_each_entry (thread, &ready_list[DL_PRIORITY], list) {
+        if (thread->sched_policy == SCHED_DEADLINE)
+            dl_check_miss(thread, now);
+    }
+
+    if (running_thread->sched_policy != SCHED_DEADLINE ||
+        running_thread->status != THREAD_RUNNING)
+        return;
+
+    dl_check_miss(running_thread, now);
+
+    /* Charge the running thread for the tick */
+    if (running_thread->dl_budget > 0)
+        running_thread->dl_budget--;
+
+    /* Throttle the thread until the next period once the budget is exhausted,
+     * unless it is holding a lock that other threads are waiting for */
+    if (running_thread->dl_budget == 0 && !running_thread->priority_inherited) {
+        running_thread->wakeup_tick = running_thread->dl_abs_deadline -
+                                      running_thread->dl_deadline +
+                                      running_thread->dl_period;
+        running_thread->status = THREAD_WAIT;
+        running_thread->throttled = true;
+        running_thread->throttle_cnt++;
+        sleep_list_add(running_thread);
+        set_need_resched();
+    }
 }
 
-static inline bool need_resched(void)
+static void sporadic_update(void)
 {
-    return need_resched_flag;
+    struct thread_info *thread = running_thread;
+
+    if (thread->sched_policy != SCHED_SPORADIC ||
+        thread->status != THREAD_RUNNING)
+        return;
+
+    ss_activate(thread);
+    ss_replenish(thread, get_sys_ticks());
+
+    /* Charge the running thread for the tick */
+    thread->ss_consumed++;
+    if (thread->ss_budget > 0)
+        thread->ss_budget--;
+
+    /* Throttle the thread until the first replenishment once the budget is
+     * exhausted, unless it is holding a lock that other threads are waiting
+     * for */
+    if (thread->ss_budget == 0 && !thread->priority_inherited) {
+        ss_deactivate(thread);
+        thread->wakeup_tick = thread->ss_repl[0].tick;
+        thread->status = THREAD_WAIT;
+        thread->throttled = true;
+        thread->throttle_cnt++;
+        sleep_list_add(thread);
+        set_need_resched();
+    }
+}
+
+static void round_robin_update(void)
+{
+    /* Only the SCHED_RR threads are rotated, and only when the time slice
+     * expired. Other preemptions are triggered by the wake-up events */
+    if (running_thread->sched_policy == SCHED_RR &&
+        running_thread->status == THREAD_RUNNING &&
+        --running_thread->time_slice == 0)
+        set_need_resched();
 }
 
 void system_ticks_update(void)
@@ -2986,15 +3939,50 @@ void system_ticks_update(void)
     __preempt_disable();
 
     system_timer_update();
+    cputime_update();
+    loadavg_update();
     threads_ticks_update();
     timers_update();
     syscall_timeout_update();
+    deadline_update();
+    sporadic_update();
+    round_robin_update();
 
-    set_need_resched();
+    /* Switch the thread only if required */
+    if (need_resched())
+        request_context_switch();
 
     __preempt_enable();
 }
 
+void system_hrtimer_update(void)
+{
+    preempt_disable();
+
+    ktime_t now = ktime_get_ns();
+
+    /* The hrsleep list is sorted by the wake-up time, hence only the threads
+     * at the front of the list need to be checked */
+    while (!list_empty(&hrsleep_list)) {
+        struct thread_info *thread =
+            list_first_entry(&hrsleep_list, struct thread_info, list);
+
+        /* Rearm the hrtimer for the first thread that still needs to sleep.
+         * Times shorter than the timer resolution are considered expired */
+        if (thread->wakeup_ns - now >= 1000) {
+            hrtimer_program(thread->wakeup_ns - now);
+            break;
+        }
+
+        /* Enqueue the thread into the ready list */
+        list_del_init(&thread->list);
+        ready_list_add(thread);
+        check_preempt_wakeup(thread);
+    }
+
+    preempt_enable();
+}
+
 static void syscall_return_event_handler(void)
 {
     running_thread->stack_top =
@@ -3056,8 +4044,14 @@ static void setup_syscall(struct thread_info *thread,
     __stack_init((uint32_t **) &thread->stack_top, func, return_handler, args);
 }
 
-/* Syscall table */
-static struct syscall_info syscall_table[] = {SYSCALL_TABLE_INIT};
+/* Syscall table indexed by the syscall number */
+static const unsigned long syscall_table[SYSCALL_TABLE_SIZE] = {
+    SYSCALL_TABLE_INIT};
+
+/* Table of the short and non-blocking syscalls that are executed directly
+ * by the SVC handler without returning to the kernel loop */
+const unsigned long syscall_fast_table[SYSCALL_TABLE_SIZE] = {
+    SYSCALL_FAST_TABLE_INIT};
 
 void set_syscall_flag(void)
 {
@@ -3076,7 +4070,8 @@ bool get_syscall_flag(void)
 
 static void syscall_handler(void)
 {
-    unsigned long syscall_num = get_syscall_num(running_thread->stack_top);
+    unsigned long syscall_num = get_syscall_num(running_thread->stack_top) &
+                                ~SYSCALL_SLOW_PATH;
 
     /* Match request with system event table */
     switch (syscall_num) {
@@ -3096,24 +4091,22 @@ static void syscall_handler(void)
         return;
     }
 
-    /* Match request with system call table */
-    for (int i = 0; i < SYSCALL_CNT; i++) {
-        if (syscall_num == syscall_table[i].num) {
-            if (running_thread->syscall_mode)
-                return;
+    /* Look up the system call table with the syscall number */
+    if (syscall_num < SYSCALL_TABLE_SIZE && syscall_table[syscall_num]) {
+        if (running_thread->syscall_mode)
+            return;
 
-            get_syscall_args(running_thread->stack_top,
-                             running_thread->syscall_args);
+        get_syscall_args(running_thread->stack_top,
+                         running_thread->syscall_args);
 
-            setup_syscall(running_thread, syscall_table[i].handler_func,
-                          (uint32_t) syscall_return_handler,
-                          *running_thread->syscall_args);
+        setup_syscall(running_thread, syscall_table[syscall_num],
+                      (uint32_t) syscall_return_handler,
+                      *running_thread->syscall_args);
 
-            running_thread->privilege = KERNEL_THREAD;
-            running_thread->syscall_mode = true;
+        running_thread->privilege = KERNEL_THREAD;
+        running_thread->syscall_mode = true;
 
-            return;
-        }
+        return;
     }
 
     /* Unknown request */
@@ -3128,35 +4121,41 @@ static void syscall_handler(void)
 
 static void __schedule(void)
 {
-    /* Stop current thread */
-    if (running_thread->status == THREAD_RUNNING)
-        prepare_to_wait(&sleep_list, running_thread, THREAD_WAIT);
+    struct thread_info *prev = running_thread;
 
-    /* Wake up threads that the sleep tick is exhausted */
-    struct list_head *curr, *next;
-    list_for_each_safe (curr, next, &sleep_list) {
-        /* Acquire the thread control block */
-        struct thread_info *thread = list_entry(curr, struct thread_info, list);
+    /* Charge the CPU time to the thread being switched out */
+    cputime_update();
 
-        /* Enqueue the thread into the ready list if it is ready */
-        if (thread->sleep_ticks == 0) {
-            list_move(curr, &ready_list[thread->priority]);
-            thread->status = THREAD_READY;
+    if (running_thread->status == THREAD_RUNNING) {
+        if (running_thread->time_slice == 0) {
+            /* Time slice expired, place the thread to the tail of the ready
+             * list with a new time slice */
+            running_thread->time_slice = SCHED_RR_TIMESLICE;
+            ready_list_add(running_thread);
+        } else {
+            /* Preempted, place the thread to the front of the ready list */
+            ready_list_add_head(running_thread);
         }
-    }
-
-    /* Find a ready list that contains runnable threads */
-    int pri;
-    for (pri = KTHREAD_PRI_MAX; pri >= 0; pri--) {
-        if (list_empty(&ready_list[pri]) == false)
-            break;
-    }
+    } else if (running_thread->sched_policy == SCHED_SPORADIC)
+        ss_deactivate(running_thread); /* The thread is blocked */
 
-    /* Select the first thread from the ready list */
-    running_thread =
-        list_first_entry(&ready_list[pri], struct thread_info, list);
+    /* Select the first thread from the highest-priority ready list */
+    running_thread = ready_list_first();
     running_thread->status = THREAD_RUNNING;
-    list_del(&running_thread->list);
+    ready_list_del(running_thread);
+
+    /* Start consuming the budget of the sporadic server thread */
+    if (running_thread->sched_policy == SCHED_SPORADIC)
+        ss_activate(running_thread);
+
+    /* Count the context switch as involuntary if the previous thread was
+     * still runnable or throttled for exhausting its budget */
+    if (running_thread != prev) {
+        if (prev->status == THREAD_READY || prev->throttled)
+            prev->nivcsw++;
+        else
+            prev->nvcsw++;
+    }
 
     /* Check if the thread has pending signals */
     if (!running_thread->syscall_mode)
@@ -3272,6 +4271,61 @@ static void start_init_thread(void)
     pthread_join(tid, NULL);
 }
 
+#if (USE_TICKLESS_IDLE != 0)
+/* Calculate the ticks left before the earliest event that requires the tick
+ * handler, i.e., the sleeping threads, the timers or the syscall timeouts */
+static uint32_t next_event_ticks(void)
+{
+    uint32_t now = get_sys_ticks();
+    uint32_t ticks = UINT32_MAX;
+
+    if (!list_empty(&sleep_list)) {
+        struct thread_info *thread =
+            list_first_entry(&sleep_list, struct thread_info, list);
+        if (thread->wakeup_tick - now < ticks)
+            ticks = thread->wakeup_tick - now;
+    }
+
+    if (!list_empty(&timeout_list)) {
+        struct thread_info *thread =
+            list_first_entry(&timeout_list, struct thread_info, timeout_list);
+        if (thread->timeout_tick - now < ticks)
+            ticks = thread->timeout_tick - now;
+    }
+
+    for (int i = 0; i < TIMER_WHEEL_SIZE; i++) {
+        struct timer *timer;
+        list_for_each_entry (timer, &timer_wheel[i], g_list) {
+            if (timer->expire_tick - now < ticks)
+                ticks = timer->expire_tick - now;
+        }
+    }
+
+    return ticks;
+}
+
+static void tickless_idle(void)
+{
+    preempt_disable();
+
+    /* Stop the periodic tick only if no other thread is ready to run */
+    uint32_t ticks = 0;
+    if (!ready_bitmap && !need_resched())
+        ticks = next_event_ticks();
+
+    if (ticks > 1) {
+        /* Idle until the next event and compensate the passed ticks */
+        uint32_t elapsed_ticks = __idle_ticks(ticks);
+        system_timer_skip(elapsed_ticks);
+
+        preempt_enable();
+    } else {
+        preempt_enable();
+        __idle();
+    }
+}
+#endif
+
 static void idle(void)
 {
     setprogname("idle");
@@ -3281,10 +4335,33 @@ static void idle(void)
 
     /* Run idle loop when nothing to do */
     while (1) {
+#if (USE_TICKLESS_IDLE != 0)
+        tickless_idle();
+#else
         __idle();
+#endif
     }
 }
 
+void *sched_switch(void *stack_top, uint32_t *privilege)
+{
+    /* Save the stack pointer of the preempted thread */
+    running_thread->stack_top = stack_top;
+
+    /* Rescheduling request */
+    if (need_resched()) {
+        reset_need_resched();
+        __schedule();
+    }
+
+    /* Check thread stack pointer to detect stack overflow */
+    check_thread_stack();
+
+    /* Return the stack pointer and the privilege of the next thread */
+    *privilege = running_thread->privilege;
+    return running_thread->stack_top;
+}
+
 void sched_start(void)
 {
     __platform_init();
@@ -3298,6 +4375,11 @@ void sched_start(void)
         INIT_LIST_HEAD(&ready_list[i]);
     }
 
+    /* Initialize the timer wheel */
+    for (int i = 0; i < TIMER_WHEEL_SIZE; i++) {
+        INIT_LIST_HEAD(&timer_wheel[i]);
+    }
+
     /* Create kernel threads for basic services */
     kthread_create(idle, 0, IDLE_STACK_SIZE);
     kthread_create(softirqd, KTHREAD_PRI_MAX, SOFTIRQD_STACK_SIZE);
@@ -3306,8 +4388,11 @@ void sched_start(void)
 
     /* Dequeue and execute the init thread */
     running_thread = &threads[0];
+    ready_list_del(&threads[0]);
     threads[0].status = THREAD_RUNNING;
-    list_del(&threads[0].list);
+    cputime_stamp = __clocksource_read();
+    loadavg_stamp = cputime_stamp;
+    loadavg_next_tick = OS_TICK_FREQ;
 
     while (1) {
         /* Syscall request */
@@ -3325,8 +4410,11 @@ void sched_start(void)
         /* Check thread stack pointer to detect stack overflow */
         check_thread_stack();
 
-        /* Jump to the selected thread */
-        running_thread->stack_top = jump_to_thread(running_thread->stack_top,
-                                                   running_thread->privilege);
+        /* Jump to the selected thread. Note that the returning thread may
+         * differ from the one being jumped to as the PendSV handler can
+         * switch threads directly */
+        void *stack_top = jump_to_thread(running_thread->stack_top,
+                                         running_thread->privilege);
+        running_thread->stack_top = stack_top;
     }
 }
@@ -4,6 +4,7 @@
 #include <string.h>
 
 #include <common/list.h>
+#include <kernel/atomic.h>
 #include <kernel/errno.h>
 #include <kernel/kernel.h>
 #include <kernel/mutex.h>
@@ -16,6 +17,7 @@ void __mutex_init(struct mutex *mtx)
 {
     memset(mtx, 0, sizeof(*mtx));
     INIT_LIST_HEAD(&mtx->wait_list);
+    INIT_LIST_HEAD(&mtx->pi_list);
 }
 
 void mutex_init(struct mutex *mtx)
@@ -24,13 +26,21 @@ void mutex_init(struct mutex *mtx)
     mtx->protocol = PTHREAD_PRIO_INHERIT;
 }
 
-bool mutex_is_locked(struct mutex *mtx)
+/* Check if the priority of the thread exceeds the priority ceiling */
+static bool mutex_ceiling_violated(struct mutex *mtx,
+                                   struct thread_info *thread)
 {
-    preempt_disable();
-    bool retval = mtx->owner != NULL;
-    preempt_enable();
+    if (mtx->protocol != PTHREAD_PRIO_PROTECT)
+        return false;
 
-    return retval;
+    uint8_t priority = thread->priority_inherited ? thread->original_priority
+                                                  : thread->priority;
+    return priority > mtx->prioceiling;
+}
+
+bool mutex_is_locked(struct mutex *mtx)
+{
+    return mtx->owner != 0;
 }
 
 int mutex_trylock(struct mutex *mtx)
@@ -41,44 +51,80 @@ int mutex_trylock(struct mutex *mtx)
 
     CURRENT_THREAD_INFO(curr_thread);
 
-    /* Check if the mutex is occupied */
-    if (mtx->owner != NULL) {
-        /* Enqueue current thread into the waiting list */
-        prepare_to_wait(&mtx->wait_list, curr_thread, THREAD_WAIT);
+    if (mutex_ceiling_violated(mtx, curr_thread)) {
+        retval = -EINVAL;
+        goto leave;
+    }
 
+    /* Occupy the mutex by setting the owner if it is not locked */
+    if (cmpxchg(&mtx->owner, 0, (unsigned long) curr_thread) != 0) {
         retval = -EBUSY;
-    } else {
-        /* Occupy the mutex by setting the owner */
-        mtx->owner = curr_thread;
-
-        retval = 0;
+        goto leave;
     }
 
-    preempt_enable();
+    /* Raise the priority to the ceiling */
+    if (mtx->protocol == PTHREAD_PRIO_PROTECT)
+        thread_raise_ceiling(mtx);
 
+    retval = 0;
+
+leave:
+    preempt_enable();
     return retval;
 }
 
 int mutex_lock(struct mutex *mtx)
 {
+    preempt_disable();
+
     int retval;
 
-    while (1) {
-        retval = mutex_trylock(mtx);
+    CURRENT_THREAD_INFO(curr_thread);
+
+    if (mutex_ceiling_violated(mtx, curr_thread)) {
+        retval = -EINVAL;
+        goto leave;
+    }
+
+    while (mtx->owner != 0) {
+        /* Record the blocking mutex for the priority inheritance chain */
+        curr_thread->blocked_on = mtx;
+
+        /* Force the owner to unlock with the slow path for waking up the
+         * waiting threads */
+        mtx->owner |= MUTEX_WAITERS;
 
-        if (retval == -EBUSY) {
+        /* Enqueue current thread into the waiting list */
+        prepare_to_wait(&mtx->wait_list, curr_thread, THREAD_WAIT);
+
+        /* Raise the priority of the owner thread if required. The owner of
+         * the priority protection mutex runs at the ceiling already */
+        if (mtx->protocol == PTHREAD_PRIO_INHERIT)
             thread_inherit_priority(mtx);
-        } else {
-            break;
-        }
 
         schedule();
     }
 
-    /* Reset priority inheritance */
-    if (retval == 0)
-        thread_reset_inherited_priority(mtx);
+    curr_thread->blocked_on = NULL;
+
+    /* Occupy the mutex by setting the owner, the flag is kept if there are
+     * still other threads waiting for the mutex */
+    mtx->owner = (unsigned long) curr_thread;
+    if (!list_empty(&mtx->wait_list))
+        mtx->owner |= MUTEX_WAITERS;
 
+    if (mtx->protocol == PTHREAD_PRIO_PROTECT) {
+        /* Raise the priority to the ceiling */
+        thread_raise_ceiling(mtx);
+    } else if (mtx->owner & MUTEX_WAITERS) {
+        /* Inherit the priority of the remaining waiting threads */
+        thread_inherit_priority(mtx);
+    }
+
+    retval = 0;
+
+leave:
+    preempt_enable();
     return retval;
 }
 
@@ -91,17 +137,20 @@ int mutex_unlock(struct mutex *mtx)
     CURRENT_THREAD_INFO(curr_thread);
 
     /* Only the owner thread can unlock the mutex */
-    if (mtx->owner != curr_thread) {
+    if (mutex_owner(mtx) != curr_thread) {
         retval = -EPERM;
         goto leave;
     }
 
     /* Release the mutex */
-    mtx->owner = NULL;
+    mtx->owner = 0;
 
     /* Wake up the highest-priority thread from the waiting list */
     wake_up(&mtx->wait_list);
 
+    /* Recover the priority if it was raised by the waiting threads */
+    thread_reset_inherited_priority(mtx);
+
     /* Return success */
     retval = 0;
 
@@ -23,21 +23,15 @@ int fifo_open(struct inode *inode, struct file *file)
 
 static void fifo_wake_up(struct list_head *wait_list, size_t avail_size)
 {
-    struct thread_info *highest_pri_thread = NULL;
-
-    struct list_head *curr, *next;
-    list_for_each_safe (curr, next, wait_list) {
-        struct thread_info *thread = list_entry(curr, struct thread_info, list);
-
-        if (thread->file_request_size <= avail_size &&
-            (highest_pri_thread == NULL ||
-             thread->priority > highest_pri_thread->priority)) {
-            highest_pri_thread = thread;
+    /* The waiting list is sorted by the priority, so the first thread that
+     * can be served is the first highest-priority one */
+    struct thread_info *thread;
+    list_for_each_entry (thread, wait_list, list) {
+        if (thread->file_request_size <= avail_size) {
+            finish_wait(thread);
+            return;
         }
     }
-
-    if (highest_pri_thread)
-        finish_wait(highest_pri_thread);
 }
 
 static ssize_t __fifo_read(struct file *filp, char *buf, size_t size)
@@ -5,10 +5,13 @@
 
 #include <arch/port.h>
 #include <common/list.h>
+#include <kernel/atomic.h>
 #include <kernel/mutex.h>
 #include <kernel/syscall.h>
 #include <kernel/thread.h>
 
+#include "kconfig.h"
+
 int pthread_attr_init(pthread_attr_t *attr)
 {
     if (!attr)
@@ -103,6 +106,35 @@ int pthread_mutexattr_getprotocol(const pthread_mutexattr_t *attr,
     return 0;
 }
 
+int pthread_mutexattr_setprioceiling(pthread_mutexattr_t *attr,
+                                     int prioceiling)
+{
+    if (!attr)
+        return -ENOMEM;
+
+    /* The SCHED_DEADLINE threads can only lock the mutexes with the ceiling
+     * of DL_PRIORITY */
+    if (prioceiling < 0 || prioceiling > DL_PRIORITY)
+        return -EINVAL;
+
+    struct mutex_attr *mtx_attr = (struct mutex_attr *) attr;
+    mtx_attr->prioceiling = prioceiling;
+
+    return 0;
+}
+
+int pthread_mutexattr_getprioceiling(const pthread_mutexattr_t *attr,
+                                     int *prioceiling)
+{
+    if (!attr)
+        return -ENOMEM;
+
+    struct mutex_attr *mtx_attr = (struct mutex_attr *) attr;
+    *prioceiling = mtx_attr->prioceiling;
+
+    return 0;
+}
+
 int pthread_attr_setstacksize(pthread_attr_t *attr, size_t stacksize)
 {
     if (!attr)
@@ -232,6 +264,7 @@ int pthread_mutexattr_init(pthread_mutexattr_t *attr)
 
     struct mutex_attr *_attr = (struct mutex_attr *) attr;
     _attr->protocol = PTHREAD_PRIO_NONE;
+    _attr->prioceiling = THREAD_PRIORITY_MAX;
 
     return 0;
 }
@@ -256,6 +289,7 @@ int pthread_mutex_init(pthread_mutex_t *mutex, const pthread_mutexattr_t *attr)
     if (attr) {
         struct mutex_attr *_attr = (struct mutex_attr *) attr;
         _mutex->protocol = _attr->protocol;
+        _mutex->prioceiling = _attr->prioceiling;
     }
 
     return 0;
@@ -285,21 +319,98 @@ NACKED void pthread_exit(void *retval)
     SYSCALL(PTHREAD_EXIT);
 }
 
-NACKED int pthread_mutex_unlock(pthread_mutex_t *mutex)
+static NACKED int __pthread_mutex_unlock(pthread_mutex_t *mutex)
 {
     SYSCALL(PTHREAD_MUTEX_UNLOCK);
 }
 
-NACKED int pthread_mutex_lock(pthread_mutex_t *mutex)
+static NACKED int __pthread_mutex_lock(pthread_mutex_t *mutex)
 {
     SYSCALL(PTHREAD_MUTEX_LOCK);
 }
 
-NACKED int pthread_mutex_trylock(pthread_mutex_t *mutex)
+static NACKED int __pthread_mutex_trylock(pthread_mutex_t *mutex)
 {
     SYSCALL(PTHREAD_MUTEX_TRYLOCK);
 }
 
+int pthread_mutex_unlock(pthread_mutex_t *mutex)
+{
+    struct mutex *mtx = (struct mutex *) mutex;
+    unsigned long curr_thread = (unsigned long) current_thread_info();
+
+    /* Fast path: Release the mutex without entering the kernel if no other
+     * thread is waiting for it. The priority protection mutex always takes
+     * the slow path to restore the priority */
+    if (mtx->protocol != PTHREAD_PRIO_PROTECT &&
+        cmpxchg(&mtx->owner, curr_thread, 0) == curr_thread)
+        return 0;
+
+    /* Slow path: Wake up the waiting threads by the kernel */
+    return __pthread_mutex_unlock(mutex);
+}
+
+int pthread_mutex_lock(pthread_mutex_t *mutex)
+{
+    struct mutex *mtx = (struct mutex *) mutex;
+
+    /* Fast path: Acquire the mutex without entering the kernel if it is not
+     * locked. The priority protection mutex always takes the slow path to
+     * raise the priority */
+    if (mtx->protocol != PTHREAD_PRIO_PROTECT &&
+        cmpxchg(&mtx->owner, 0, (unsigned long) current_thread_info()) == 0)
+        return 0;
+
+    /* Slow path: Wait for the mutex and apply priority inheritance or
+     * priority ceiling by the kernel */
+    return __pthread_mutex_lock(mutex);
+}
+
+int pthread_mutex_trylock(pthread_mutex_t *mutex)
+{
+    struct mutex *mtx = (struct mutex *) mutex;
+
+    /* The priority protection mutex always takes the slow path to check and
+     * raise the priority by the kernel */
+    if (mtx->protocol == PTHREAD_PRIO_PROTECT)
+        return __pthread_mutex_trylock(mutex);
+
+    /* Acquire the mutex without entering the kernel, which would only
+     * repeat the same attempt if the mutex is locked */
+    if (cmpxchg(&mtx->owner, 0, (unsigned long) current_thread_info()) != 0)
+        return -EBUSY;
+
+    return 0;
+}
+
+int pthread_mutex_setprioceiling(pthread_mutex_t *mutex,
+                                 int prioceiling,
+                                 int *old_ceiling)
+{
+    if (prioceiling < 0 || prioceiling > DL_PRIORITY)
+        return -EINVAL;
+
+    int retval = pthread_mutex_lock(mutex);
+    if (retval != 0)
+        return retval;
+
+    struct mutex *mtx = (struct mutex *) mutex;
+    if (old_ceiling)
+        *old_ceiling = mtx->prioceiling;
+    mtx->prioceiling = prioceiling;
+
+    return pthread_mutex_unlock(mutex);
+}
+
+int pthread_mutex_getprioceiling(const pthread_mutex_t *mutex,
+                                 int *prioceiling)
+{
+    struct mutex *mtx = (struct mutex *) mutex;
+    *prioceiling = mtx->prioceiling;
+
+    return 0;
+}
+
 int pthread_condattr_init(pthread_condattr_t *attr)
 {
     if (!attr)
@@ -347,11 +458,23 @@ NACKED int pthread_cond_broadcast(pthread_cond_t *cond)
     SYSCALL(PTHREAD_COND_BROADCAST);
 }
 
-NACKED int pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex)
+static NACKED int __pthread_cond_wait(pthread_cond_t *cond,
+                                      pthread_mutex_t *mutex)
 {
     SYSCALL(PTHREAD_COND_WAIT);
 }
 
+int pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex)
+{
+    /* Release the mutex and wait for the condition */
+    int retval = __pthread_cond_wait(cond, mutex);
+    if (retval != 0)
+        return retval;
+
+    /* Lock the mutex again before returning to the caller */
+    return pthread_mutex_lock(mutex);
+}
+
 NACKED int pthread_once(pthread_once_t *once_control,
                         void (*init_routine)(void))
 {
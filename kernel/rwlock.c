@@ -0,0 +1,363 @@
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <arch/port.h>
+#include <common/list.h>
+#include <kernel/kernel.h>
+#include <kernel/preempt.h>
+#include <kernel/rwlock.h>
+#include <kernel/sched.h>
+#include <kernel/syscall.h>
+#include <kernel/thread.h>
+#include <kernel/wait.h>
+
+void rwlock_init(struct rwlock *rwlock, bool prefer_writer)
+{
+    rwlock->count = 0;
+    rwlock->prefer_writer = prefer_writer;
+    rwlock->writer_woken = false;
+    rwlock->writer = NULL;
+    INIT_LIST_HEAD(&rwlock->read_wait_list);
+    INIT_LIST_HEAD(&rwlock->write_wait_list);
+}
+
+/* Find the record of the lock held by the thread for reading */
+static struct rwlock_hold *rwlock_hold_find(struct thread_info *thread,
+                                            struct rwlock *rwlock)
+{
+    for (int i = 0; i < RWLOCK_READ_MAX; i++) {
+        if (thread->rwlock_holds[i].rwlock == rwlock)
+            return &thread->rwlock_holds[i];
+    }
+
+    return NULL;
+}
+
+/* Check if the reader has to wait. Besides the lock being written, the
+ * reader also gives way to the woken writer that is about to take the lock,
+ * and to the waiting writers if the writers are preferred or have higher
+ * priority */
+static bool rwlock_read_blocked(struct rwlock *rwlock,
+                                struct thread_info *reader)
+{
+    if (rwlock->count < 0 || rwlock->writer_woken)
+        return true;
+
+    if (list_empty(&rwlock->write_wait_list))
+        return false;
+
+    /* The wait list is sorted by the priority */
+    struct thread_info *writer = list_first_entry(
+        &rwlock->write_wait_list, struct thread_info, list);
+
+    return rwlock->prefer_writer || writer->priority > reader->priority;
+}
+
+/* Hand over the released lock to a writer or to all the readers */
+static void rwlock_wake_up(struct rwlock *rwlock)
+{
+    if (list_empty(&rwlock->write_wait_list)) {
+        wake_up_all(&rwlock->read_wait_list);
+        return;
+    }
+
+    if (list_empty(&rwlock->read_wait_list)) {
+        rwlock->writer_woken = true;
+        wake_up(&rwlock->write_wait_list);
+        return;
+    }
+
+    struct thread_info *reader =
+        list_first_entry(&rwlock->read_wait_list, struct thread_info, list);
+    struct thread_info *writer = list_first_entry(
+        &rwlock->write_wait_list, struct thread_info, list);
+
+    /* The readers win the tie unless the writers are preferred */
+    if (rwlock->prefer_writer || writer->priority > reader->priority) {
+        rwlock->writer_woken = true;
+        wake_up(&rwlock->write_wait_list);
+    } else {
+        wake_up_all(&rwlock->read_wait_list);
+    }
+}
+
+int rwlock_rdlock(struct rwlock *rwlock)
+{
+    preempt_disable();
+
+    int retval;
+
+    CURRENT_THREAD_INFO(curr_thread);
+
+    /* The writer can't lock for reading without releasing the lock */
+    if (rwlock->writer == curr_thread) {
+        retval = -EDEADLK;
+        goto leave;
+    }
+
+    /* Find the record of the lock or a free one */
+    struct rwlock_hold *hold = rwlock_hold_find(curr_thread, rwlock);
+    if (!hold)
+        hold = rwlock_hold_find(curr_thread, NULL);
+    if (!hold) {
+        retval = -EAGAIN;
+        goto leave;
+    }
+
+    /* A reader that already holds the lock doesn't wait, otherwise it
+     * deadlocks with the writers waiting for it */
+    while (hold->cnt == 0 && rwlock_read_blocked(rwlock, curr_thread)) {
+        /* Enqueue current thread into the reader waiting list */
+        prepare_to_wait(&rwlock->read_wait_list, curr_thread, THREAD_WAIT);
+
+        schedule();
+    }
+
+    /* Acquired the read lock successfully */
+    rwlock->count++;
+    hold->rwlock = rwlock;
+    hold->cnt++;
+
+    retval = 0;
+
+leave:
+    preempt_enable();
+    return retval;
+}
+
+int rwlock_tryrdlock(struct rwlock *rwlock)
+{
+    preempt_disable();
+
+    int retval;
+
+    CURRENT_THREAD_INFO(curr_thread);
+
+    /* Find the record of the lock or a free one */
+    struct rwlock_hold *hold = rwlock_hold_find(curr_thread, rwlock);
+    if (!hold)
+        hold = rwlock_hold_find(curr_thread, NULL);
+    if (!hold) {
+        retval = -EAGAIN;
+        goto leave;
+    }
+
+    if (hold->cnt == 0 && rwlock_read_blocked(rwlock, curr_thread)) {
+        retval = -EBUSY;
+        goto leave;
+    }
+
+    /* Acquired the read lock successfully */
+    rwlock->count++;
+    hold->rwlock = rwlock;
+    hold->cnt++;
+
+    retval = 0;
+
+leave:
+    preempt_enable();
+    return retval;
+}
+
+int rwlock_wrlock(struct rwlock *rwlock)
+{
+    preempt_disable();
+
+    int retval;
+
+    CURRENT_THREAD_INFO(curr_thread);
+
+    /* The write lock is not recursive, and the reader can't upgrade the
+     * lock without releasing it */
+    if (rwlock->writer == curr_thread ||
+        rwlock_hold_find(curr_thread, rwlock)) {
+        retval = -EDEADLK;
+        goto leave;
+    }
+
+    while (rwlock->count != 0) {
+        /* Enqueue current thread into the writer waiting list */
+        prepare_to_wait(&rwlock->write_wait_list, curr_thread, THREAD_WAIT);
+
+        schedule();
+    }
+
+    /* Acquired the write lock successfully */
+    rwlock->count = -1;
+    rwlock->writer = curr_thread;
+    rwlock->writer_woken = false;
+
+    retval = 0;
+
+leave:
+    preempt_enable();
+    return retval;
+}
+
+int rwlock_trywrlock(struct rwlock *rwlock)
+{
+    preempt_disable();
+
+    int retval;
+
+    CURRENT_THREAD_INFO(curr_thread);
+
+    if (rwlock->count != 0) {
+        retval = -EBUSY;
+    } else {
+        /* Acquired the write lock successfully */
+        rwlock->count = -1;
+        rwlock->writer = curr_thread;
+        rwlock->writer_woken = false;
+
+        retval = 0;
+    }
+
+    preempt_enable();
+
+    return retval;
+}
+
+int rwlock_unlock(struct rwlock *rwlock)
+{
+    preempt_disable();
+
+    int retval;
+
+    CURRENT_THREAD_INFO(curr_thread);
+
+    if (rwlock->count < 0) {
+        /* Only the writer can release the write lock */
+        if (rwlock->writer != curr_thread) {
+            retval = -EPERM;
+            goto leave;
+        }
+
+        rwlock->count = 0;
+        rwlock->writer = NULL;
+    } else if (rwlock->count > 0) {
+        /* Only the readers can release the read lock */
+        struct rwlock_hold *hold = rwlock_hold_find(curr_thread, rwlock);
+        if (!hold) {
+            retval = -EPERM;
+            goto leave;
+        }
+
+        if (--hold->cnt == 0)
+            hold->rwlock = NULL;
+        rwlock->count--;
+    } else {
+        /* The lock is not held */
+        retval = -EPERM;
+        goto leave;
+    }
+
+    /* Wake up the waiting threads after the last holder left */
+    if (rwlock->count == 0)
+        rwlock_wake_up(rwlock);
+
+    retval = 0;
+
+leave:
+    preempt_enable();
+    return retval;
+}
+
+int pthread_rwlockattr_init(pthread_rwlockattr_t *attr)
+{
+    if (!attr)
+        return -ENOMEM;
+
+    struct rwlock_attr *_attr = (struct rwlock_attr *) attr;
+    _attr->kind = PTHREAD_RWLOCK_PREFER_READER_NP;
+
+    return 0;
+}
+
+int pthread_rwlockattr_destroy(pthread_rwlockattr_t *attr)
+{
+    if (!attr)
+        return -ENOMEM;
+
+    memset(attr, 0, sizeof(pthread_rwlockattr_t));
+    return 0;
+}
+
+int pthread_rwlockattr_setkind_np(pthread_rwlockattr_t *attr, int pref)
+{
+    if (!attr)
+        return -ENOMEM;
+
+    if (pref != PTHREAD_RWLOCK_PREFER_READER_NP &&
+        pref != PTHREAD_RWLOCK_PREFER_WRITER_NP)
+        return -EINVAL;
+
+    struct rwlock_attr *_attr = (struct rwlock_attr *) attr;
+    _attr->kind = pref;
+
+    return 0;
+}
+
+int pthread_rwlockattr_getkind_np(const pthread_rwlockattr_t *attr,
+                                  int *pref)
+{
+    if (!attr)
+        return -ENOMEM;
+
+    struct rwlock_attr *_attr = (struct rwlock_attr *) attr;
+    *pref = _attr->kind;
+
+    return 0;
+}
+
+int pthread_rwlock_init(pthread_rwlock_t *rwlock,
+                        const pthread_rwlockattr_t *attr)
+{
+    if (!rwlock)
+        return -ENOMEM;
+
+    bool prefer_writer = false;
+    if (attr) {
+        struct rwlock_attr *_attr = (struct rwlock_attr *) attr;
+        prefer_writer = _attr->kind == PTHREAD_RWLOCK_PREFER_WRITER_NP;
+    }
+
+    rwlock_init((struct rwlock *) rwlock, prefer_writer);
+    return 0;
+}
+
+int pthread_rwlock_destroy(pthread_rwlock_t *rwlock)
+{
+    if (!rwlock)
+        return -ENOMEM;
+
+    memset(rwlock, 0, sizeof(pthread_rwlock_t));
+    return 0;
+}
+
+NACKED int pthread_rwlock_rdlock(pthread_rwlock_t *rwlock)
+{
+    SYSCALL(PTHREAD_RWLOCK_RDLOCK);
+}
+
+NACKED int pthread_rwlock_tryrdlock(pthread_rwlock_t *rwlock)
+{
+    SYSCALL(PTHREAD_RWLOCK_TRYRDLOCK);
+}
+
+NACKED int pthread_rwlock_wrlock(pthread_rwlock_t *rwlock)
+{
+    SYSCALL(PTHREAD_RWLOCK_WRLOCK);
+}
+
+NACKED int pthread_rwlock_trywrlock(pthread_rwlock_t *rwlock)
+{
+    SYSCALL(PTHREAD_RWLOCK_TRYWRLOCK);
+}
+
+NACKED int pthread_rwlock_unlock(pthread_rwlock_t *rwlock)
+{
+    SYSCALL(PTHREAD_RWLOCK_UNLOCK);
+}
@@ -1,5 +1,7 @@
 #include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
+#include <sys/sched.h>
 #include <sys/types.h>
 #include <tenok.h>
 #include <time.h>
@@ -11,6 +13,10 @@
 
 inline int sched_get_priority_max(int policy)
 {
+    /* SCHED_DEADLINE threads are not scheduled by the priority */
+    if (policy == SCHED_DEADLINE)
+        return 0;
+
     return THREAD_PRIORITY_MAX;
 }
 
@@ -21,8 +27,10 @@ inline int sched_get_priority_min(int policy)
 
 int sched_rr_get_interval(pid_t pid, struct timespec *tp)
 {
-    tp->tv_sec = OS_TICK_FREQ / 1000;
-    tp->tv_nsec = (1000000000 / OS_TICK_FREQ) % 1000000000;
+    /* All SCHED_RR threads share the same time slice */
+    tp->tv_sec = SCHED_RR_TIMESLICE / OS_TICK_FREQ;
+    tp->tv_nsec =
+        (SCHED_RR_TIMESLICE % OS_TICK_FREQ) * (1000000000 / OS_TICK_FREQ);
 
     return 0;
 }
@@ -43,17 +51,70 @@ unsigned int sleep(unsigned int seconds)
     return 0;
 }
 
-int usleep(useconds_t usec)
+static void period_advance(struct period_info *pinfo)
 {
-    /* FIXME: Granularity is too large in current design */
+    pinfo->next_period.tv_sec += pinfo->period.tv_sec;
+    pinfo->next_period.tv_nsec += pinfo->period.tv_nsec;
 
-    int usec_tick = OS_TICK_FREQ * usec / 1000000;
-    long granularity_us = 1000000 / OS_TICK_FREQ;
+    if (pinfo->next_period.tv_nsec >= 1000000000) {
+        pinfo->next_period.tv_sec++;
+        pinfo->next_period.tv_nsec -= 1000000000;
+    }
+}
 
-    if ((usec >= 1000000) || (usec < granularity_us)) {
+static bool period_passed(struct period_info *pinfo, struct timespec *now)
+{
+    return now->tv_sec > pinfo->next_period.tv_sec ||
+           (now->tv_sec == pinfo->next_period.tv_sec &&
+            now->tv_nsec >= pinfo->next_period.tv_nsec);
+}
+
+int period_init(struct period_info *pinfo, long period_ns)
+{
+    if (period_ns <= 0)
         return -EINVAL;
-    } else {
-        delay_ticks(usec_tick);
-        return 0;
+
+    pinfo->period.tv_sec = period_ns / 1000000000;
+    pinfo->period.tv_nsec = period_ns % 1000000000;
+    pinfo->overruns = 0;
+
+    /* The first period starts after a period from now */
+    clock_gettime(CLOCK_MONOTONIC, &pinfo->next_period);
+    period_advance(pinfo);
+
+    return 0;
+}
+
+int period_wait(struct period_info *pinfo)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    /* Skip the periods that were overrun by the loop body */
+    int missed = 0;
+    while (period_passed(pinfo, &now)) {
+        period_advance(pinfo);
+        missed++;
     }
+    pinfo->overruns += missed;
+
+    int retval =
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &pinfo->next_period,
+                        NULL);
+    if (retval < 0)
+        return retval;
+
+    period_advance(pinfo);
+
+    return missed;
+}
+
+int usleep(useconds_t usec)
+{
+    struct timespec req = {
+        .tv_sec = usec / 1000000,
+        .tv_nsec = (usec % 1000000) * 1000,
+    };
+
+    return nanosleep(&req, NULL);
 }
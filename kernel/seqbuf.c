@@ -0,0 +1,51 @@
+#include <errno.h>
+#include <seqbuf.h>
+#include <string.h>
+
+#include <kernel/seqlock.h>
+
+/* Get the copy (sequence & 1) of the double buffer */
+static inline void *seqbuf_copy(struct seqbuf *sb, uint32_t seq)
+{
+    return (char *) sb->data + (seq & 1) * sb->size;
+}
+
+int seqbuf_init(seqbuf_t *seqbuf, void *storage, size_t size)
+{
+    if (!seqbuf || !storage)
+        return -ENOMEM;
+
+    if (size == 0)
+        return -EINVAL;
+
+    struct seqbuf *sb = (struct seqbuf *) seqbuf;
+    seqcount_init(&sb->seq);
+    sb->data = storage;
+    sb->size = size;
+    memset(storage, 0, 2 * size);
+
+    return 0;
+}
+
+void seqbuf_write(seqbuf_t *seqbuf, const void *value)
+{
+    struct seqbuf *sb = (struct seqbuf *) seqbuf;
+
+    /* Update the copy not used by the readers, then switch the readers to
+     * it. Since the writer is the only one changing the sequence, no
+     * locking is required */
+    uint32_t seq = sb->seq.sequence;
+    memcpy(seqbuf_copy(sb, seq + 1), value, sb->size);
+    write_seqcount_latch(&sb->seq);
+}
+
+void seqbuf_read(seqbuf_t *seqbuf, void *value)
+{
+    struct seqbuf *sb = (struct seqbuf *) seqbuf;
+    uint32_t seq;
+
+    do {
+        seq = read_seqcount_begin(&sb->seq);
+        memcpy(value, seqbuf_copy(sb, seq), sb->size);
+    } while (read_seqcount_latch_retry(&sb->seq, seq));
+}
@@ -27,9 +27,7 @@ void tasklet_schedule(struct tasklet_struct *t)
     list_move(&t->list, &tasklet_list);
 
     /* Wake up the SoftIRQ daemon */
-    int softirqd_tid = get_daemon_id(SOFTIRQD);
-    struct thread_info *thread = acquire_thread(softirqd_tid);
-    finish_wait(thread);
+    finish_wait(get_daemon_thread(SOFTIRQD));
 }
 
 static void softirqd_sleep(void)
@@ -1,4 +1,5 @@
 #include <stdint.h>
+#include <sys/sysinfo.h>
 #include <task.h>
 #include <tenok.h>
 
@@ -10,6 +11,30 @@ NACKED void *thread_info(struct thread_stat *info, void *next)
     SYSCALL(THREAD_INFO);
 }
 
+NACKED int thread_cputime(struct timespec *tp)
+{
+    SYSCALL(THREAD_CPUTIME);
+}
+
+NACKED int sysinfo(struct sysinfo *info)
+{
+    SYSCALL(SYSINFO);
+}
+
+int getloadavg(double loadavg[], int nelem)
+{
+    struct sysinfo info;
+    sysinfo(&info);
+
+    if (nelem > 3)
+        nelem = 3;
+
+    for (int i = 0; i < nelem; i++)
+        loadavg[i] = (double) info.loads[i] / (1 << SI_LOAD_SHIFT);
+
+    return nelem;
+}
+
 NACKED void setprogname(const char *name)
 {
     SYSCALL(SETPROGNAME);
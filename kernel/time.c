@@ -1,6 +1,9 @@
+#include <errno.h>
+#include <tenok.h>
 #include <time.h>
 
 #include <arch/port.h>
+#include <kernel/seqlock.h>
 #include <kernel/syscall.h>
 #include <kernel/time.h>
 
@@ -8,7 +11,19 @@
 
 #define NANOSECOND_TICKS (1000000000 / OS_TICK_FREQ)
 
-static struct timespec sys_time;
+/* The system time is published with the clocksource count it was sampled
+ * at, so readers can extrapolate it without entering the kernel. The kernel
+ * is the only writer and makes the sequence counter odd while writing, so
+ * readers retry if they observed an odd or changed counter */
+struct time_page {
+    struct seqcount seq;
+    struct timespec time;    /* System time at the last update */
+    uint32_t cycles;         /* Clocksource count at the last update */
+    ktime_t realtime_offset; /* CLOCK_REALTIME minus the system time */
+};
+
+static struct time_page time_page;
+static uint32_t sys_ticks; /* Monotonic tick counter since boot */
 
 void timer_up_count(struct timespec *time)
 {
@@ -44,34 +59,135 @@ void time_add(struct timespec *time, time_t sec, long nsec)
     }
 }
 
+static void time_page_update(void)
+{
+    uint32_t mhz = __clocksource_freq() / 1000000;
+
+    /* Only whole microseconds are accounted so no fraction is lost between
+     * the updates */
+    uint32_t usec = (__clocksource_read() - time_page.cycles) / mhz;
+
+    write_seqcount_begin(&time_page.seq);
+
+    time_page.cycles += usec * mhz;
+    time_add(&time_page.time, usec / 1000000, (usec % 1000000) * 1000);
+
+    write_seqcount_end(&time_page.seq);
+}
+
 void system_timer_update(void)
 {
-    timer_up_count(&sys_time);
+    sys_ticks++;
+    time_page_update();
+}
+
+void system_timer_skip(uint32_t ticks)
+{
+    /* Compensate the ticks passed without running the tick handler, the
+     * time is kept by the clocksource already */
+    sys_ticks += ticks;
+    time_page_update();
+}
+
+uint32_t get_sys_ticks(void)
+{
+    return sys_ticks;
+}
+
+uint32_t timespec_to_ticks(const struct timespec *tp)
+{
+    /* Round up so the waiting time is never shorter than requested */
+    return tp->tv_sec * OS_TICK_FREQ +
+           (tp->tv_nsec + NANOSECOND_TICKS - 1) / NANOSECOND_TICKS;
+}
+
+void ticks_to_timespec(uint32_t ticks, struct timespec *tp)
+{
+    tp->tv_sec = ticks / OS_TICK_FREQ;
+    tp->tv_nsec = (ticks % OS_TICK_FREQ) * NANOSECOND_TICKS;
 }
 
 void get_sys_time(struct timespec *tp)
 {
-    *tp = sys_time;
+    uint32_t seq, cycles;
+
+    do {
+        seq = read_seqcount_begin(&time_page.seq);
+
+        *tp = time_page.time;
+        cycles = time_page.cycles;
+    } while (read_seqcount_retry(&time_page.seq, seq));
+
+    /* Extrapolate the time passed since the last update */
+    uint32_t mhz = __clocksource_freq() / 1000000;
+    uint32_t delta = __clocksource_read() - cycles;
+    uint32_t usec = delta / mhz;
+    uint32_t nsec = (delta % mhz) * 1000 / mhz;
+    time_add(tp, usec / 1000000, (usec % 1000000) * 1000 + nsec);
+}
+
+void get_sys_realtime(struct timespec *tp)
+{
+    uint32_t seq;
+    ktime_t offset;
+
+    do {
+        seq = read_seqcount_begin(&time_page.seq);
+        offset = time_page.realtime_offset;
+    } while (read_seqcount_retry(&time_page.seq, seq));
+
+    ktime_t ns = ktime_get_ns() + offset;
+    tp->tv_sec = ns / 1000000000;
+    tp->tv_nsec = ns % 1000000000;
+}
+
+void set_sys_realtime(const struct timespec *tp)
+{
+    /* Only the offset of the real time is changed, so the system time stays
+     * monotonic for the sleeping threads and the timers */
+    ktime_t offset =
+        (ktime_t) tp->tv_sec * 1000000000 + tp->tv_nsec - ktime_get_ns();
+
+    write_seqcount_begin(&time_page.seq);
+    time_page.realtime_offset = offset;
+    write_seqcount_end(&time_page.seq);
 }
 
-void set_sys_time(const struct timespec *tp)
+ktime_t ktime_get_ns(void)
 {
-    sys_time = *tp;
+    struct timespec tp;
+    get_sys_time(&tp);
+
+    return (ktime_t) tp.tv_sec * 1000000000 + tp.tv_nsec;
 }
 
 int clock_getres(clockid_t clockid, struct timespec *res)
 {
     // TODO: Check clock ID
 
+    uint32_t mhz = __clocksource_freq() / 1000000;
+
     res->tv_sec = 0;
-    res->tv_nsec = NANOSECOND_TICKS;
+    res->tv_nsec = (1000 + mhz - 1) / mhz;
 
     return 0;
 }
 
-NACKED int clock_gettime(clockid_t clockid, struct timespec *tp)
+int clock_gettime(clockid_t clockid, struct timespec *tp)
 {
-    SYSCALL(CLOCK_GETTIME);
+    /* The CPU time is only known by the kernel */
+    if (clockid == CLOCK_THREAD_CPUTIME_ID)
+        return thread_cputime(tp);
+
+    /* Read the time page directly instead of issuing a syscall */
+    if (clockid == CLOCK_REALTIME)
+        get_sys_realtime(tp);
+    else if (clockid == CLOCK_MONOTONIC)
+        get_sys_time(tp);
+    else
+        return -EINVAL;
+
+    return 0;
 }
 
 NACKED int clock_settime(clockid_t clk_id, const struct timespec *tp)
@@ -79,6 +195,19 @@ NACKED int clock_settime(clockid_t clk_id, const struct timespec *tp)
     SYSCALL(CLOCK_SETTIME);
 }
 
+NACKED int clock_nanosleep(clockid_t clockid,
+                           int flags,
+                           const struct timespec *req,
+                           struct timespec *rem)
+{
+    SYSCALL(CLOCK_NANOSLEEP);
+}
+
+int nanosleep(const struct timespec *req, struct timespec *rem)
+{
+    return clock_nanosleep(CLOCK_MONOTONIC, 0, req, rem);
+}
+
 NACKED int timer_create(clockid_t clockid,
                         struct sigevent *sevp,
                         timer_t *timerid)
@@ -122,5 +251,8 @@ void msleep(unsigned int msecs)
 
 ktime_t ktime_get(void)
 {
-    return sys_time.tv_sec * 1000 + sys_time.tv_nsec / 1000000;
+    struct timespec tp;
+    get_sys_time(&tp);
+
+    return tp.tv_sec * 1000 + tp.tv_nsec / 1000000;
 }
@@ -116,6 +116,9 @@ SRC += ./kernel/arch/v7m_port.c \
        ./kernel/mqueue.c \
        ./kernel/mutex.c \
        ./kernel/semaphore.c \
+       ./kernel/rwlock.c \
+       ./kernel/event.c \
+       ./kernel/seqbuf.c \
        ./kernel/pthread.c \
        ./kernel/signal.c \
        ./kernel/time.c \
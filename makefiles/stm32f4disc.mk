@@ -30,9 +30,11 @@ SRC += ./user/tasks/mavlink_task.c
 #SRC += ./user/tasks/examples/semaphore.c
 #SRC += ./user/tasks/examples/mutex-ex.c
 #SRC += ./user/tasks/examples/priority-inversion.c
+#SRC += ./user/tasks/examples/priority-inheritance-chain.c
 #SRC += ./user/tasks/examples/signal-ex.c
 #SRC += ./user/tasks/examples/timer-ex.c
 #SRC += ./user/tasks/examples/poll-ex.c
+#SRC += ./user/tasks/examples/timed-wait-cancel.c
 #SRC += ./user/tasks/examples/pthread-ex.c
 
 flash:
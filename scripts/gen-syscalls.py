@@ -4,6 +4,7 @@ import datetime
 
 syscalls = \
     ['thread_info',
+     'thread_cputime',
      'setprogname',
      'delay_ticks',
      'task_create',
@@ -26,6 +27,7 @@ syscalls = \
      'getcwd',
      'chdir',
      'getpid',
+     'sysinfo',
      'mknod',
      'mkfifo',
      'poll',
@@ -53,6 +55,14 @@ syscalls = \
      'pthread_cond_broadcast',
      'pthread_cond_wait',
      'pthread_once',
+     'pthread_rwlock_rdlock',
+     'pthread_rwlock_tryrdlock',
+     'pthread_rwlock_wrlock',
+     'pthread_rwlock_trywrlock',
+     'pthread_rwlock_unlock',
+     'event_set',
+     'event_clear',
+     'event_wait',
      'sem_post',
      'sem_trywait',
      'sem_wait',
@@ -61,8 +71,8 @@ syscalls = \
      'sigwait',
      'kill',
      'raise',
-     'clock_gettime',
      'clock_settime',
+     'clock_nanosleep',
      'timer_create',
      'timer_delete',
      'timer_settime',
@@ -70,6 +80,18 @@ syscalls = \
      'malloc',
      'free']
 
+# Short and non-blocking syscalls that are executed directly by the SVC
+# handler instead of going through the kernel loop
+fast_syscalls = \
+    ['getpid',
+     'pthread_self',
+     'thread_cputime',
+     'sem_trywait',
+     'pthread_rwlock_tryrdlock',
+     'pthread_rwlock_trywrlock',
+     'mq_getattr',
+     'minfo']
+
 reserved_events = [
     'SYSCALL_RETURN_EVENT',
     'SIGNAL_CLEANUP_EVENT',
@@ -77,8 +99,13 @@ reserved_events = [
     'THREAD_ONCE_EVENT']
 
 syscall_cnt = len(syscalls)
+fast_syscall_cnt = len(fast_syscalls)
 reserved_events_cnt = len(reserved_events)
 
+# The numbers must stay below SYSCALL_SLOW_PATH (see include/arch/port.h)
+if syscall_cnt + reserved_events_cnt + 1 > 0x80:
+    raise ValueError('too many syscalls for the SYSCALL_SLOW_PATH flag')
+
 print('// GENERATED. DO NOT EDIT FROM HERE!')
 print('// Change definitions in scripts/gen-syscalls.py')
 print('// Created on ' +
@@ -91,7 +118,11 @@ print('/* clang-format off */')
 print('#ifndef __KERNEL_SYSCALL_H__')
 print('#define __KERNEL_SYSCALL_H__\n')
 
-print('#define SYSCALL_CNT %d\n' % (syscall_cnt))
+print('#define SYSCALL_CNT %d' % (syscall_cnt))
+
+# Syscall numbers are dense and start from 1 (0 is used by the kernel to
+# initialize the environment), so the table can be indexed by the number
+print('#define SYSCALL_TABLE_SIZE %d\n' % (syscall_cnt + 1))
 
 for i in range(0, syscall_cnt):
     id = syscalls[i].upper()
@@ -114,5 +145,17 @@ for i in range(0, syscall_cnt):
     else:
         print('    DEF_SYSCALL(%s, %s), \\' % (syscall, id))
 
+print('#define SYSCALL_FAST_TABLE_INIT \\')
+
+for i in range(0, fast_syscall_cnt):
+    syscall = fast_syscalls[i]
+    id = fast_syscalls[i].upper()
+    if syscall not in syscalls:
+        raise ValueError('unknown fast syscall: ' + syscall)
+    if i == fast_syscall_cnt - 1:
+        print('    DEF_SYSCALL(%s, %s) \\\n' % (syscall, id))
+    else:
+        print('    DEF_SYSCALL(%s, %s), \\' % (syscall, id))
+
 print('#endif')
 print('/* clang-format on */')
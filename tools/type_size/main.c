@@ -1,7 +1,12 @@
+#include <event.h>
+#include <seqbuf.h>
 #include <stdio.h>
 
+#include <kernel/event.h>
 #include <kernel/mutex.h>
+#include <kernel/rwlock.h>
 #include <kernel/semaphore.h>
+#include <kernel/seqlock.h>
 #include <kernel/thread.h>
 
 #define PRINT_SIZE(size_macro, type) \
@@ -14,7 +19,11 @@ int main(void)
     PRINT_SIZE(__SIZEOF_PTHREAD_ATTR_T, struct thread_attr);
     PRINT_SIZE(__SIZEOF_PTHREAD_COND_T, struct cond);
     PRINT_SIZE(__SIZEOF_PTHREAD_ONCE_T, struct thread_once);
+    PRINT_SIZE(__SIZEOF_PTHREAD_RWLOCKATTR_T, struct rwlock_attr);
+    PRINT_SIZE(__SIZEOF_PTHREAD_RWLOCK_T, struct rwlock);
     PRINT_SIZE(__SIZEOF_SEM_T, struct semaphore);
+    PRINT_SIZE(__SIZEOF_EVENT_T, struct event_group);
+    PRINT_SIZE(__SIZEOF_SEQBUF_T, struct seqbuf);
 
     return 0;
 }
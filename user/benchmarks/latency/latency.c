@@ -0,0 +1,92 @@
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "kconfig.h"
+#include "shell.h"
+
+#define LATENCY_ROUNDS 100
+#define LATENCY_SLEEP_US 1500 /* Not a multiple of the tick period */
+
+static volatile bool waiter_done;
+static long min_us, max_us, sum_us;
+
+static long timespec_diff_us(struct timespec *end, struct timespec *start)
+{
+    return (end->tv_sec - start->tv_sec) * 1000000 +
+           (end->tv_nsec - start->tv_nsec) / 1000;
+}
+
+static void *latency_waiter(void *arg)
+{
+    for (int i = 0; i < LATENCY_ROUNDS; i++) {
+        /* Sleep until an absolute time that drifts against the tick, the
+         * thread is woken up by the hrtimer interrupt handler */
+        struct timespec target, now;
+        clock_gettime(CLOCK_MONOTONIC, &target);
+        target.tv_nsec += (LATENCY_SLEEP_US + i * 37) * 1000;
+        if (target.tv_nsec >= 1000000000) {
+            target.tv_sec++;
+            target.tv_nsec -= 1000000000;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, NULL);
+
+        /* Measure the time from the interrupt to the thread running */
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        long latency_us = timespec_diff_us(&now, &target);
+        if (latency_us < min_us)
+            min_us = latency_us;
+        if (latency_us > max_us)
+            max_us = latency_us;
+        sum_us += latency_us;
+    }
+
+    waiter_done = true;
+
+    return NULL;
+}
+
+int latency(int argc, char *argv[])
+{
+    min_us = __LONG_MAX__;
+    max_us = 0;
+    sum_us = 0;
+    waiter_done = false;
+
+    /* The waiter thread should outrank the shell thread */
+    int policy;
+    struct sched_param param;
+    pthread_getschedparam(pthread_self(), &policy, &param);
+    param.sched_priority++;
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setschedparam(&attr, &param);
+    pthread_attr_setstacksize(&attr, 1024);
+
+    printf("Measuring IRQ-to-thread latency for %d rounds...\n\r",
+           LATENCY_ROUNDS);
+
+    pthread_t tid;
+    if (pthread_create(&tid, &attr, latency_waiter, NULL) < 0) {
+        printf("latency: failed to create the waiter thread\n\r");
+        return 0;
+    }
+
+    /* Busy waiting so the shell never gives up the CPU voluntarily. The
+     * waiter can only run once its wake-up from the interrupt preempts the
+     * shell, otherwise it waits for the next tick */
+    while (!waiter_done)
+        ;
+
+    pthread_join(tid, NULL);
+
+    printf("min: %d us, max: %d us, avg: %d us (tick period: %d us)\n\r",
+           (int) min_us, (int) max_us, (int) (sum_us / LATENCY_ROUNDS),
+           1000000 / OS_TICK_FREQ);
+
+    return 0;
+}
+
+HOOK_SHELL_CMD("latency", latency);
@@ -0,0 +1,3 @@
+PROJ_ROOT := $(dir $(lastword $(MAKEFILE_LIST)))/../../..
+
+SRC += $(PROJ_ROOT)/user/benchmarks/latency/latency.c
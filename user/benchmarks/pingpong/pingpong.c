@@ -0,0 +1,63 @@
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "shell.h"
+
+#define PINGPONG_ROUNDS 10000
+
+static sem_t ping_sem, pong_sem;
+
+static void *pong_thread(void *arg)
+{
+    for (int i = 0; i < PINGPONG_ROUNDS; i++) {
+        sem_wait(&pong_sem);
+        sem_post(&ping_sem);
+    }
+
+    return NULL;
+}
+
+int pingpong(int argc, char *argv[])
+{
+    sem_init(&ping_sem, 0, 0);
+    sem_init(&pong_sem, 0, 0);
+
+    /* Both threads run with the same priority, so every round trip takes
+     * two context switches caused by blocking on the semaphores */
+    pthread_t tid;
+    if (pthread_create(&tid, NULL, pong_thread, NULL) < 0) {
+        printf("pingpong: failed to create the pong thread\n\r");
+        return 0;
+    }
+
+    printf("Running %d ping-pong rounds...\n\r", PINGPONG_ROUNDS);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (int i = 0; i < PINGPONG_ROUNDS; i++) {
+        sem_post(&pong_sem);
+        sem_wait(&ping_sem);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    pthread_join(tid, NULL);
+
+    long elapsed_us = (end.tv_sec - start.tv_sec) * 1000000 +
+                      (end.tv_nsec - start.tv_nsec) / 1000;
+    if (elapsed_us <= 0)
+        elapsed_us = 1;
+
+    long switches = 2 * PINGPONG_ROUNDS;
+    long switches_per_sec = (long) ((long long) switches * 1000000 / elapsed_us);
+
+    printf("%d context switches in %d us (%d switches/s)\n\r", (int) switches,
+           (int) elapsed_us, (int) switches_per_sec);
+
+    return 0;
+}
+
+HOOK_SHELL_CMD("pingpong", pingpong);
@@ -0,0 +1,77 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/sysinfo.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <arch/port.h>
+#include <kernel/syscall.h>
+
+#include "shell.h"
+
+#define SYSCALL_BENCH_CALLS 10000
+
+/* The same getpid() syscall but always dispatched by the kernel loop, as
+ * without the fast path */
+static NACKED int getpid_slow_path(void)
+{
+    SYSCALL_SLOW(GETPID);
+}
+
+static long timespec_diff_ns(struct timespec *end, struct timespec *start)
+{
+    return (end->tv_sec - start->tv_sec) * 1000000000 +
+           (end->tv_nsec - start->tv_nsec);
+}
+
+static void syscall_bench_report(const char *name,
+                                 long elapsed_ns,
+                                 unsigned long cpu_freq)
+{
+    /* Average cost of one call in nanoseconds and CPU cycles */
+    long ns_per_call = elapsed_ns / SYSCALL_BENCH_CALLS;
+    long cycles_per_call =
+        (long) ((int64_t) elapsed_ns * (cpu_freq / 1000000) / 1000 /
+                SYSCALL_BENCH_CALLS);
+
+    printf("%-24s %6d ns/call %6d cycles/call\n\r", name, (int) ns_per_call,
+           (int) cycles_per_call);
+}
+
+int syscall_bench(int argc, char *argv[])
+{
+    struct timespec start, end;
+
+    struct sysinfo info;
+    sysinfo(&info);
+
+    printf("Running %d calls for each path...\n\r", SYSCALL_BENCH_CALLS);
+
+    /* Fast path: executed directly by the SVC handler */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < SYSCALL_BENCH_CALLS; i++)
+        getpid();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    syscall_bench_report("getpid (fast path)", timespec_diff_ns(&end, &start),
+                         info.cpu_freq);
+
+    /* Slow path: the same syscall dispatched by the kernel loop */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < SYSCALL_BENCH_CALLS; i++)
+        getpid_slow_path();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    syscall_bench_report("getpid (slow path)", timespec_diff_ns(&end, &start),
+                         info.cpu_freq);
+
+    /* No syscall: read from the shared time page */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < SYSCALL_BENCH_CALLS; i++)
+        clock_gettime(CLOCK_MONOTONIC, &end);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    syscall_bench_report("clock_gettime (time page)",
+                         timespec_diff_ns(&end, &start), info.cpu_freq);
+
+    return 0;
+}
+
+HOOK_SHELL_CMD("syscall", syscall_bench);
@@ -1,6 +1,7 @@
 #include <fcntl.h>
 #include <ioctl.h>
 #include <math.h>
+#include <seqbuf.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <task.h>
@@ -11,6 +12,7 @@
 #include "debug_link_attitude_msg.h"
 #include "debug_link_imu_msg.h"
 #include "debug_link_pid_msg.h"
+#include "debug_link_sysload_msg.h"
 #include "madgwick_filter.h"
 #include "pwm.h"
 #include "sbus.h"
@@ -32,14 +34,8 @@
 #define THRUST_PWM_MAX 2075  // 2.075 ms
 #define THRUST_PWM_DIFF (THRUST_PWM_MAX - THRUST_PWM_MIN)
 
-#define FLIGHT_CTRL_FREQ 400                             // Hz
-#define FLIGHT_CTRL_PERIOD (1000.0f / FLIGHT_CTRL_FREQ)  // Millisecond
-
-/* 10x faster than the control loop frequency we want for
- * enough precision. Note that the unit is microsecond.
- * sleep_time = (1 / freq * 1000) / 10
- */
-#define FLIGHT_CTRL_SLEEP_TIME (100000 / FLIGHT_CTRL_FREQ)
+#define FLIGHT_CTRL_FREQ 400                                 // Hz
+#define FLIGHT_CTRL_PERIOD (1000000000L / FLIGHT_CTRL_FREQ)  // Nanosecond
 
 typedef struct {
     float kp;
@@ -60,6 +56,13 @@ typedef struct {
     bool enable;
 } pid_control_t;
 
+/* Attitude published by the flight control task for the debug link */
+typedef struct {
+    float q[4];
+    float rpy[3];
+    float error_rpy[3];
+} attitude_t;
+
 static pid_control_t pid_roll = {
     .kp = 0.008f,
     .kd = 0.003f,
@@ -89,6 +92,11 @@ static float rpy[3];
 static float motors[4];
 static madgwick_t madgwick_ahrs;
 
+/* The flight control task never blocks on publishing the attitude, and the
+ * debug link task always reads a consistent copy of it */
+static seqbuf_t attitude_seqbuf;
+static SEQBUF_STORAGE(attitude_storage, attitude_t);
+
 float calc_elapsed_time(struct timespec *tp_now, struct timespec *tp_last)
 {
     return (float) (tp_now->tv_sec - tp_last->tv_sec) * 1e3 +
@@ -321,6 +329,9 @@ void flight_control_task(void)
     /* Initialize Madgwick Filter for attitude estimation */
     madgwick_init(&madgwick_ahrs, 400, 0.105);
 
+    /* Initialize the attitude sharing with the debug link task */
+    seqbuf_init(&attitude_seqbuf, attitude_storage, sizeof(attitude_t));
+
     /* Open RGB LED */
     int led_fd = open("/dev/led", 0);
     if (led_fd < 0) {
@@ -367,6 +378,7 @@ void flight_control_task(void)
 
     sbus_t rc;
     float throttle;
+    attitude_t attitude;
 
     /* Wait until RC joystick positions are reset */
     rc_safety_protection(rc_fd, led_fd);
@@ -378,24 +390,17 @@ void flight_control_task(void)
     /* Initialize thrusts for motor 1 to 4 */
     disable_all_motors(pwm_fd);
 
-    /* Execution time */
-    struct timespec time_last, time_now;
-    float time_elapsed = 0.0f;
-    clock_gettime(CLOCK_MONOTONIC, &time_last);
+    /* Loop frequency control */
+    struct period_info period;
+    period_init(&period, FLIGHT_CTRL_PERIOD);
 
     /* Forbid ESC calibration */
     flight_ctrl_running = true;
 
     while (1) {
-        /* Loop frequency control */
-        while (time_elapsed < FLIGHT_CTRL_PERIOD) {
-            usleep(FLIGHT_CTRL_SLEEP_TIME);
-
-            clock_gettime(CLOCK_MONOTONIC, &time_now);
-            time_elapsed = calc_elapsed_time(&time_now, &time_last);
-        }
-        time_last = time_now;
-        time_elapsed = 0;
+        /* Sleep until the next period, the overruns are counted in
+         * period.overruns */
+        period_wait(&period);
 
         /* Read RC signal */
         read(rc_fd, &rc, sizeof(sbus_t));
@@ -428,6 +433,19 @@ void flight_control_task(void)
         quadrotor_thrust_allocation(throttle, pid_roll.output, pid_pitch.output,
                                     pid_yaw_rate.output, motors);
 
+        /* Publish the attitude for the debug link */
+        attitude.q[0] = madgwick_ahrs.q[0];
+        attitude.q[1] = madgwick_ahrs.q[1];
+        attitude.q[2] = madgwick_ahrs.q[2];
+        attitude.q[3] = madgwick_ahrs.q[3];
+        attitude.rpy[0] = rpy[0];
+        attitude.rpy[1] = rpy[1];
+        attitude.rpy[2] = rpy[2];
+        attitude.error_rpy[0] = pid_roll.output;
+        attitude.error_rpy[1] = pid_pitch.output;
+        attitude.error_rpy[2] = 0.0f;
+        seqbuf_write(&attitude_seqbuf, &attitude);
+
         /* Enable motor outputs only if the safety switch is off and
          * the throttle is greater than 5% */
         if (rc.dual_switch1) {
@@ -481,8 +499,11 @@ void debug_link_task(void)
     debug_link_msg_imu_t imu_msg;
     debug_link_msg_attitude_t att_msg;
     debug_link_msg_pid_t pid_msg;
+    debug_link_msg_sysload_t sysload_msg;
+    attitude_t attitude;
     uint8_t buf[100];
     size_t size;
+    int sysload_cnt = 0;
 
     /* 40Hz */
     while (1) {
@@ -497,21 +518,37 @@ void debug_link_task(void)
         size = pack_debug_link_imu_msg(&imu_msg, buf);
         write(debug_link_fd, buf, size);
 
-        att_msg.q[0] = madgwick_ahrs.q[0];
-        att_msg.q[1] = madgwick_ahrs.q[1];
-        att_msg.q[2] = madgwick_ahrs.q[2];
-        att_msg.q[3] = madgwick_ahrs.q[3];
-        att_msg.rpy[0] = rpy[0];
-        att_msg.rpy[1] = rpy[1];
-        att_msg.rpy[2] = rpy[2];
+        /* Read the latest attitude published by the flight control task */
+        seqbuf_read(&attitude_seqbuf, &attitude);
+
+        att_msg.q[0] = attitude.q[0];
+        att_msg.q[1] = attitude.q[1];
+        att_msg.q[2] = attitude.q[2];
+        att_msg.q[3] = attitude.q[3];
+        att_msg.rpy[0] = attitude.rpy[0];
+        att_msg.rpy[1] = attitude.rpy[1];
+        att_msg.rpy[2] = attitude.rpy[2];
         size = pack_debug_link_attitude_msg(&att_msg, buf);
         write(debug_link_fd, buf, size);
 
-        pid_msg.error_rpy[0] = pid_roll.output;
-        pid_msg.error_rpy[1] = pid_pitch.output;
-        pid_msg.error_rpy[2] = 0.0f;
+        pid_msg.error_rpy[0] = attitude.error_rpy[0];
+        pid_msg.error_rpy[1] = attitude.error_rpy[1];
+        pid_msg.error_rpy[2] = attitude.error_rpy[2];
         size = pack_debug_link_pid_msg(&pid_msg, buf);
         write(debug_link_fd, buf, size);
+
+        /* The load averages are updated every second */
+        if (++sysload_cnt == 40) {
+            double loadavg[3];
+            getloadavg(loadavg, 3);
+            sysload_msg.loadavg[0] = loadavg[0];
+            sysload_msg.loadavg[1] = loadavg[1];
+            sysload_msg.loadavg[2] = loadavg[2];
+            size = pack_debug_link_sysload_msg(&sysload_msg, buf);
+            write(debug_link_fd, buf, size);
+            sysload_cnt = 0;
+        }
+
         usleep(25000);
     }
 }
@@ -1,3 +1,4 @@
+#include <sched.h>
 #include <stdio.h>
 #include <string.h>
 #include <tenok.h>
@@ -30,12 +31,19 @@ static void ps_print(void)
         char s_stack_usage[10] = {0};
         stack_usage(s_stack_usage, 10, info.stack_usage, info.stack_size);
 
+        /* Deadline threads are shown with the number of deadline misses */
+        char s_priority[10] = {0};
+        if (info.policy == SCHED_DEADLINE)
+            snprintf(s_priority, 10, "DL(%d)", (int) info.dl_misses);
+        else
+            snprintf(s_priority, 10, "%d", info.priority);
+
         if (info.kernel_thread) {
-            snprintf(s, 100, "%d\t%d\t%s\t%s\t  [%s]\n\r", info.pid,
-                     info.priority, info.status, s_stack_usage, info.name);
+            snprintf(s, 100, "%d\t%s\t%s\t%s\t  [%s]\n\r", info.pid,
+                     s_priority, info.status, s_stack_usage, info.name);
         } else {
-            snprintf(s, 100, "%d\t%d\t%s\t%s\t  %s\n\r", info.pid,
-                     info.priority, info.status, s_stack_usage, info.name);
+            snprintf(s, 100, "%d\t%s\t%s\t%s\t  %s\n\r", info.pid,
+                     s_priority, info.status, s_stack_usage, info.name);
         }
 
         shell_puts(s);
@@ -50,6 +58,8 @@ int ps(int argc, char *argv[])
     } else if (argc == 2 &&
                (!strcmp("-h", argv[1]) || !strcmp("--help", argv[1]))) {
         shell_puts(
+            "priority:\n\r"
+            "  DL(n) SCHED_DEADLINE thread with n deadline misses\n\r"
             "process state codes:\n\r"
             "  R    running or runnable\n\r"
             "  T    stopped (suspended)\n\r"
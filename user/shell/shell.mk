@@ -16,6 +16,7 @@ SRC += $(PROJ_ROOT)/user/shell/echo.c
 SRC += $(PROJ_ROOT)/user/shell/help.c
 SRC += $(PROJ_ROOT)/user/shell/ls.c
 SRC += $(PROJ_ROOT)/user/shell/ps.c
+SRC += $(PROJ_ROOT)/user/shell/top.c
 SRC += $(PROJ_ROOT)/user/shell/xxd.c
 SRC += $(PROJ_ROOT)/user/shell/uname.c
 SRC += $(PROJ_ROOT)/user/shell/uptime.c
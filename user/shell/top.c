@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <tenok.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "kconfig.h"
+#include "shell.h"
+
+/* CPU time of the threads sampled at the last refresh (indexed by the tid) */
+static uint64_t last_cpu_time[THREAD_MAX];
+
+static uint64_t timespec_to_ns(struct timespec *tp)
+{
+    return (uint64_t) tp->tv_sec * 1000000000 + tp->tv_nsec;
+}
+
+static void top_sample(void)
+{
+    struct thread_stat info;
+    void *next = NULL;
+
+    /* Forget the threads sampled by the previous run of the command */
+    memset(last_cpu_time, 0, sizeof(last_cpu_time));
+
+    do {
+        next = thread_info(&info, next);
+        last_cpu_time[info.tid] = info.cpu_time;
+    } while (next != NULL);
+}
+
+static void top_print(uint64_t elapsed_ns)
+{
+    char s[PRINT_SIZE_MAX] = {0};
+
+    struct thread_stat info;
+    void *next = NULL;
+
+    shell_puts("PID\tPR\t%CPU\t   TIME\t  VCSW\t NVCSW\t  COMMAND\n\r");
+
+    do {
+        next = thread_info(&info, next);
+
+        /* CPU usage since the last refresh in units of 0.1%. A smaller CPU
+         * time means the thread slot was reused by a new thread */
+        uint64_t delta = info.cpu_time >= last_cpu_time[info.tid]
+                             ? info.cpu_time - last_cpu_time[info.tid]
+                             : info.cpu_time;
+        int usage = elapsed_ns ? (int) (delta * 1000 / elapsed_ns) : 0;
+        last_cpu_time[info.tid] = info.cpu_time;
+
+        /* Total CPU time in units of 10ms */
+        int time = (int) (info.cpu_time / 10000000);
+
+        char *fmt = info.kernel_thread
+                        ? "%d\t%d\t%2d.%d\t%4d.%02d\t%6u\t%6u\t  [%s]\n\r"
+                        : "%d\t%d\t%2d.%d\t%4d.%02d\t%6u\t%6u\t  %s\n\r";
+        snprintf(s, PRINT_SIZE_MAX, fmt, info.pid, info.priority, usage / 10,
+                 usage % 10, time / 100, time % 100, info.nvcsw, info.nivcsw,
+                 info.name);
+        shell_puts(s);
+    } while (next != NULL);
+}
+
+int top(int argc, char *argv[])
+{
+    int iterations = 1;
+
+    if (argc == 3 && !strcmp("-n", argv[1])) {
+        iterations = atoi(argv[2]);
+    } else if (argc != 1) {
+        shell_puts("Usage: top [-n iterations]\n\r");
+        return 1;
+    }
+
+    struct timespec tp;
+    clock_gettime(CLOCK_MONOTONIC, &tp);
+    uint64_t last_ns = timespec_to_ns(&tp);
+    top_sample();
+
+    for (int i = 0; i < iterations; i++) {
+        /* Measure the CPU usage over a second */
+        sleep(1);
+
+        clock_gettime(CLOCK_MONOTONIC, &tp);
+        uint64_t now_ns = timespec_to_ns(&tp);
+
+        if (i > 0)
+            shell_puts("\n\r");
+        top_print(now_ns - last_ns);
+
+        last_ns = now_ns;
+    }
+
+    return 0;
+}
+
+HOOK_SHELL_CMD("top", top);
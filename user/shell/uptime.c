@@ -1,17 +1,23 @@
 #include <stdio.h>
-#include <time.h>
+#include <sys/sysinfo.h>
 
 #include "shell.h"
 
+/* Convert the fixed-point load to the integer and fraction parts */
+#define LOAD_INT(x) ((x) >> SI_LOAD_SHIFT)
+#define LOAD_FRAC(x) LOAD_INT(((x) & ((1 << SI_LOAD_SHIFT) - 1)) * 100)
+
 int uptime(int argc, char *argv[])
 {
-    struct timespec tp;
-    clock_gettime(CLOCK_MONOTONIC, &tp);
-
-    // TODO: printf() should support %lld
-    int time_sec = (int) tp.tv_sec;
+    struct sysinfo info;
+    sysinfo(&info);
 
-    printf("%d seconds up\n\r", time_sec);
+    printf("%d seconds up, %d threads, load average: %d.%02d, %d.%02d, "
+           "%d.%02d\n\r",
+           (int) info.uptime, info.procs, (int) LOAD_INT(info.loads[0]),
+           (int) LOAD_FRAC(info.loads[0]), (int) LOAD_INT(info.loads[1]),
+           (int) LOAD_FRAC(info.loads[1]), (int) LOAD_INT(info.loads[2]),
+           (int) LOAD_FRAC(info.loads[2]));
 
     return 0;
 }
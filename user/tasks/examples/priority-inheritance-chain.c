@@ -0,0 +1,114 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <task.h>
+#include <tenok.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Lock chain: high -> mutex_b (held by mid) -> mutex_a (held by low) */
+static pthread_mutex_t mutex_a;
+static pthread_mutex_t mutex_b;
+
+static void pi_mutex_init(pthread_mutex_t *mutex)
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT);
+    pthread_mutex_init(mutex, &attr);
+}
+
+void pi_chain_task_high(void)
+{
+    setprogname("pi-chain-high");
+
+    /* Wait until the lock chain is formed */
+    sleep(3);
+
+    while (1) {
+        printf("[pi chain high] attempt to lock mutex b\n\r");
+
+        struct timespec start_time, end_time;
+        clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+        /* The priority is passed to the mid and the low threads */
+        pthread_mutex_lock(&mutex_b);
+
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+        printf("[pi chain high] mutex b is locked after %d seconds\n\r",
+               (int) (end_time.tv_sec - start_time.tv_sec));
+
+        pthread_mutex_unlock(&mutex_b);
+
+        sleep(10);
+    }
+}
+
+void pi_chain_task_median(void)
+{
+    setprogname("pi-chain-median");
+
+    /* Occupy the CPU to block the low thread after 4 seconds */
+    sleep(4);
+
+    struct timespec start_time, curr_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    while (1) {
+        clock_gettime(CLOCK_MONOTONIC, &curr_time);
+
+        if ((curr_time.tv_sec - start_time.tv_sec) > 10)
+            break;
+    }
+
+    /* Pause the thread after the job is finish */
+    while (1) {
+        pause();
+    }
+}
+
+void pi_chain_task_mid(void)
+{
+    setprogname("pi-chain-mid");
+
+    /* Let the low thread lock mutex a first */
+    sleep(1);
+
+    while (1) {
+        /* Hold mutex b while waiting for mutex a */
+        pthread_mutex_lock(&mutex_b);
+        pthread_mutex_lock(&mutex_a);
+
+        printf("[pi chain mid] mutex a and b are locked\n\r");
+
+        pthread_mutex_unlock(&mutex_a);
+        pthread_mutex_unlock(&mutex_b);
+
+        sleep(10);
+    }
+}
+
+void pi_chain_task_low(void)
+{
+    setprogname("pi-chain-low");
+
+    pi_mutex_init(&mutex_a);
+    pi_mutex_init(&mutex_b);
+
+    while (1) {
+        pthread_mutex_lock(&mutex_a);
+
+        printf("[pi chain low] mutex a is locked\n\r");
+
+        /* Simulate some works */
+        sleep(5);
+
+        pthread_mutex_unlock(&mutex_a);
+
+        sleep(10);
+    }
+}
+
+HOOK_USER_TASK(pi_chain_task_high, 3, STACK_SIZE_MIN);
+HOOK_USER_TASK(pi_chain_task_median, 2, STACK_SIZE_MIN);
+HOOK_USER_TASK(pi_chain_task_mid, 1, STACK_SIZE_MIN);
+HOOK_USER_TASK(pi_chain_task_low, 0, STACK_SIZE_MIN);
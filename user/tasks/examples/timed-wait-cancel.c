@@ -0,0 +1,81 @@
+#include <errno.h>
+#include <event.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <task.h>
+#include <tenok.h>
+#include <time.h>
+#include <unistd.h>
+
+static event_t event;
+static volatile bool waiter_resumed;
+
+static void *timed_waiter(void *arg)
+{
+    /* Block with a timeout, the thread is canceled before it expires */
+    struct timespec timeout = {.tv_sec = 2, .tv_nsec = 0};
+    uint32_t bits = 0x1;
+    event_wait(&event, &bits, EVENT_WAIT_ANY, &timeout);
+
+    waiter_resumed = true;
+
+    return NULL;
+}
+
+static void *timeout_checker(void *arg)
+{
+    /* Reuse the thread slot of the canceled waiter and check the timeout
+     * still works */
+    struct timespec timeout = {.tv_sec = 1, .tv_nsec = 0};
+    uint32_t bits = 0x1;
+    int retval = event_wait(&event, &bits, EVENT_WAIT_ANY, &timeout);
+
+    printf("[timed wait cancel] new waiter %s\n\r",
+           retval == -ETIMEDOUT ? "timed out as expected" : "failed");
+
+    return NULL;
+}
+
+static pthread_t create_thread(void *(*start_routine)(void *))
+{
+    pthread_attr_t attr;
+    struct sched_param param;
+    param.sched_priority = 1;
+    pthread_attr_init(&attr);
+    pthread_attr_setschedparam(&attr, &param);
+    pthread_attr_setstacksize(&attr, 1024);
+
+    pthread_t tid;
+    pthread_create(&tid, &attr, start_routine, NULL);
+
+    return tid;
+}
+
+void timed_wait_cancel_task(void)
+{
+    setprogname("timed-wait-cancel");
+
+    event_init(&event);
+
+    while (1) {
+        waiter_resumed = false;
+
+        /* Cancel the waiter in the middle of its timed wait */
+        pthread_t tid = create_thread(timed_waiter);
+        sleep(1);
+        pthread_cancel(tid);
+
+        /* The canceled waiter must not be woken up by its timeout */
+        sleep(2);
+        printf("[timed wait cancel] canceled waiter %s\n\r",
+               waiter_resumed ? "resumed after being canceled" : "stays gone");
+
+        tid = create_thread(timeout_checker);
+        pthread_join(tid, NULL);
+
+        sleep(1);
+    }
+}
+
+HOOK_USER_TASK(timed_wait_cancel_task, 0, 1024);
@@ -41,6 +41,9 @@ void mavlink_out_task(void)
 
     mavlink_message_t recvd_msg;
 
+    struct period_info period;
+    period_init(&period, 200000000); /* 5Hz */
+
     while (1) {
         mavlink_send_heartbeat(fd);
         mavlink_send_hil_actuator_controls(fd);
@@ -51,7 +54,7 @@ void mavlink_out_task(void)
             parse_mavlink_msg(&recvd_msg);
         }
 
-        sleep(200); /* 5Hz */
+        period_wait(&period);
     }
 }
 